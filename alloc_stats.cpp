@@ -0,0 +1,77 @@
+//
+//  alloc_stats.cpp
+//  Fish-Fillet-Project
+//
+
+#include "alloc_stats.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Plain counters only: anything with a constructor could allocate, or run
+// after the first allocation it is meant to count
+static thread_local AllocationStats threadCounts;
+static std::atomic<uint64_t> totalAllocations(0);
+static std::atomic<uint64_t> totalFrees(0);
+static std::atomic<uint64_t> totalBytes(0);
+
+static void* countedAlloc(std::size_t size) {
+    ++threadCounts.allocations;
+    threadCounts.bytes += size;
+    totalAllocations.fetch_add(1, std::memory_order_relaxed);
+    totalBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+static void countedFree(void* p) {
+    if (!p) return;
+    ++threadCounts.frees;
+    totalFrees.fetch_add(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+AllocationStats threadAllocations() {
+    return threadCounts;
+}
+
+AllocationStats processAllocations() {
+    AllocationStats stats;
+    stats.allocations = totalAllocations.load(std::memory_order_relaxed);
+    stats.frees = totalFrees.load(std::memory_order_relaxed);
+    stats.bytes = totalBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void* operator new(std::size_t size) {
+    void* p = countedAlloc(size);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAlloc(size);
+}
+
+void operator delete(void* p) noexcept {
+    countedFree(p);
+}
+
+void operator delete[](void* p) noexcept {
+    countedFree(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    countedFree(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    countedFree(p);
+}
@@ -0,0 +1,34 @@
+//
+//  alloc_stats.h
+//  Fish-Fillet-Project
+//
+//  Heap allocation counters. alloc_stats.cpp replaces the global operator
+//  new and delete with versions that count calls and bytes per thread and
+//  for the whole process, then forward to malloc and free. Reading the
+//  counters before and after a stretch of play shows whether it touched the
+//  heap; the simulation is meant not to once a round is under way.
+//
+
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+#include <cstdint>
+
+struct AllocationStats {
+    uint64_t allocations;  // operator new calls
+    uint64_t frees;        // operator delete calls with a non-null pointer
+    uint64_t bytes;        // Bytes requested from operator new
+};
+
+// Counts for the calling thread since it started
+AllocationStats threadAllocations();
+
+// Counts for every thread since the program started
+AllocationStats processAllocations();
+
+// Allocations made between two readings
+inline uint64_t allocationsSince(const AllocationStats& before, const AllocationStats& after) {
+    return after.allocations - before.allocations;
+}
+
+#endif // ALLOC_STATS_H
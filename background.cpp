@@ -0,0 +1,267 @@
+//
+//  background.cpp
+//  Fish-Fillet-Project
+//
+
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/gl.h>
+#else
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/gl.h>
+#endif
+#include "background.h"
+#include "game_config.h"
+#include "trig_tables.h"
+#include <algorithm>
+#include <cmath>
+
+// Render Constants
+const int WAVE_SEGMENTS = 100;
+const int WAVE_SPACING = 60;
+const int CORAL_COUNT = 14;
+const int CORAL_VERTICES = 9;  // Two stalk triangles and a tip
+const float CORAL_REACH = 100.0f;  // Above the seabed, tallest stalk plus sway
+
+// Wave band captured into the atlas: the largest wave radius plus the full
+// swing either side of the waterline
+const int WAVE_FRAMES = 2 * (MAX_WAVE_DELTA + 1) + 1;
+const int BAND_BOTTOM = OCEAN_HEIGHT - 40 - (MAX_WAVE_DELTA + 1);
+const int BAND_HEIGHT = 2 * (40 + MAX_WAVE_DELTA + 1);
+const int ATLAS_WIDTH = 2048;
+const int ATLAS_HEIGHT = 4096;
+
+// Wave Drawing
+static void drawWave(float cx, float cy, float radius) {
+    static const TrigTable& wave = arcTable(WAVE_SEGMENTS, -44.92f, 2.0f * PI);
+    glBegin(GL_POLYGON);
+    for (int i = 0; i < WAVE_SEGMENTS; i++) {
+        float x = radius * wave.cosv[i];
+        float y = radius * wave.sinv[i];
+        glVertex2f(x + cx, y + cy);
+    }
+    glEnd();
+}
+
+OceanBackground::OceanBackground()
+    : initialized(false), preferredMode(BACKGROUND_ATLAS), mode(BACKGROUND_LISTS),
+      gradientList(0), wavesList(0), atlasTexture(0), scrollX(0.0f), surfaceY(0.0f), seabedY(0.0f) {}
+
+void OceanBackground::setCamera(float x, float y, float worldHeight) {
+    scrollX = std::fmod(x, static_cast<float>(WINDOW_WIDTH));
+    surfaceY = worldHeight - OCEAN_HEIGHT - y;
+    seabedY = -y;
+}
+
+void OceanBackground::init() {
+    initialized = true;
+
+    // Ocean background gradient
+    gradientList = glGenLists(2);
+    wavesList = gradientList + 1;
+    glNewList(gradientList, GL_COMPILE);
+    glBegin(GL_QUADS);
+    glColor3f(0.1f, 0.4f, 0.8f);
+    glVertex2f(0, 0);
+    glVertex2f(WINDOW_WIDTH, 0);
+    glColor3f(0.05f, 0.2f, 0.5f);
+    glVertex2f(WINDOW_WIDTH, OCEAN_HEIGHT);
+    glVertex2f(0, OCEAN_HEIGHT);
+    glEnd();
+    glEndList();
+
+    // Both wave rows at rest; drawOcean translates them by waveDelta
+    glNewList(wavesList, GL_COMPILE);
+    glColor3f(0.15f, 0.5f, 0.9f);
+    for (int i = 0; i <= WINDOW_WIDTH; i += WAVE_SPACING) {
+        drawWave(i, OCEAN_HEIGHT, 40);
+    }
+    glColor3f(0.2f, 0.6f, 1.0f);
+    for (int i = 30; i <= WINDOW_WIDTH; i += WAVE_SPACING) {
+        drawWave(i, OCEAN_HEIGHT, 35);
+    }
+    glEndList();
+
+    mode = BACKGROUND_LISTS;
+    if (preferredMode == BACKGROUND_ATLAS && buildAtlas()) {
+        mode = BACKGROUND_ATLAS;
+    }
+
+    // Coral colours never change; positions are filled in per frame
+    coral.resize(CORAL_COUNT * CORAL_VERTICES);
+    for (int i = 0; i < CORAL_COUNT; ++i) {
+        for (int v = 0; v < CORAL_VERTICES; ++v) {
+            CoralVertex& cv = coral[i * CORAL_VERTICES + v];
+            bool tip = v >= 6;
+            cv.x = cv.y = 0.0f;
+            cv.r = tip ? 0.4f : 0.3f;
+            cv.g = tip ? 0.9f : 0.7f;
+            cv.b = tip ? 0.5f : 0.4f;
+            cv.a = tip ? 0.7f : 0.6f;
+        }
+    }
+}
+
+// Render every wave offset once and copy the band into the atlas. Needs a
+// 1:1 pixel mapping (the window at its design size) to copy from.
+bool OceanBackground::buildAtlas() {
+    GLint viewport[4];
+    GLint maxTexture = 0;
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTexture);
+    if (viewport[0] != 0 || viewport[1] != 0 ||
+        viewport[2] != WINDOW_WIDTH || viewport[3] != WINDOW_HEIGHT ||
+        maxTexture < ATLAS_HEIGHT || WAVE_FRAMES * BAND_HEIGHT > ATLAS_HEIGHT) {
+        return false;
+    }
+
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, ATLAS_WIDTH, ATLAS_HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    if (glGetError() != GL_NO_ERROR) {
+        glDeleteTextures(1, &atlasTexture);
+        atlasTexture = 0;
+        return false;
+    }
+
+    for (int frame = 0; frame < WAVE_FRAMES; ++frame) {
+        int waveDelta = frame - (MAX_WAVE_DELTA + 1);
+        glClear(GL_COLOR_BUFFER_BIT);
+        glCallList(gradientList);
+        glPushMatrix();
+        glTranslatef(0.0f, static_cast<float>(waveDelta), 0.0f);
+        glCallList(wavesList);
+        glPopMatrix();
+        glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, frame * BAND_HEIGHT,
+                            0, BAND_BOTTOM, WINDOW_WIDTH, BAND_HEIGHT);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    return true;
+}
+
+int waveOffsetAt(double seconds) {
+    const long limit = MAX_WAVE_DELTA + 1;
+    long step = static_cast<long>(std::floor(seconds / WAVE_STEP_SECONDS));
+    long phase = (step + limit) % (4 * limit);  // Up from -limit, then back down
+    if (phase < 0) phase += 4 * limit;
+    return static_cast<int>(phase < 2 * limit ? phase - limit : 3 * limit - phase);
+}
+
+float coralPhaseAt(double seconds) {
+    // Wrap in double so the float phase keeps its precision in long sessions.
+    // Coral also uses 0.8 * phase, so wrap where both are whole turns (5 turns).
+    return static_cast<float>(std::fmod(seconds * CORAL_SWAY_RATE, 10.0 * 3.14159265358979323846));
+}
+
+void OceanBackground::drawOcean(int waveDelta) {
+    if (!initialized) init();
+
+    glCallList(gradientList);
+    if (surfaceY > 0.0f) {
+        // Under the surface, the water goes on above the ocean band
+        float top = std::min(static_cast<float>(WINDOW_HEIGHT), OCEAN_HEIGHT + surfaceY);
+        glColor3f(0.05f, 0.2f, 0.5f);
+        glBegin(GL_QUADS);
+        glVertex2f(0, OCEAN_HEIGHT);
+        glVertex2f(WINDOW_WIDTH, OCEAN_HEIGHT);
+        glVertex2f(WINDOW_WIDTH, top);
+        glVertex2f(0, top);
+        glEnd();
+    }
+    if (surfaceY > WINDOW_HEIGHT - BAND_BOTTOM) return;  // Waves are above the window
+
+    // A second copy fills the gap when the view is part way across
+    for (int copy = 0; copy < (scrollX > 0.0f ? 2 : 1); ++copy) {
+        glPushMatrix();
+        glTranslatef(copy * WINDOW_WIDTH - scrollX, surfaceY, 0.0f);
+        drawWaves(waveDelta);
+        glPopMatrix();
+    }
+}
+
+void OceanBackground::drawWaves(int waveDelta) {
+    if (mode == BACKGROUND_ATLAS) {
+        int frame = waveDelta + (MAX_WAVE_DELTA + 1);
+        if (frame < 0) frame = 0;
+        if (frame >= WAVE_FRAMES) frame = WAVE_FRAMES - 1;
+        float u1 = WINDOW_WIDTH / static_cast<float>(ATLAS_WIDTH);
+        float v0 = frame * BAND_HEIGHT / static_cast<float>(ATLAS_HEIGHT);
+        float v1 = (frame + 1) * BAND_HEIGHT / static_cast<float>(ATLAS_HEIGHT);
+
+        glEnable(GL_TEXTURE_2D);
+        glBindTexture(GL_TEXTURE_2D, atlasTexture);
+        glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+        glBegin(GL_QUADS);
+        glTexCoord2f(0.0f, v0); glVertex2f(0, BAND_BOTTOM);
+        glTexCoord2f(u1, v0);   glVertex2f(WINDOW_WIDTH, BAND_BOTTOM);
+        glTexCoord2f(u1, v1);   glVertex2f(WINDOW_WIDTH, BAND_BOTTOM + BAND_HEIGHT);
+        glTexCoord2f(0.0f, v1); glVertex2f(0, BAND_BOTTOM + BAND_HEIGHT);
+        glEnd();
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glDisable(GL_TEXTURE_2D);
+    } else {
+        glPushMatrix();
+        glTranslatef(0.0f, static_cast<float>(waveDelta), 0.0f);
+        glCallList(wavesList);
+        glPopMatrix();
+    }
+}
+
+void OceanBackground::drawCoral(float coralPhase) {
+    if (!initialized) init();
+    if (seabedY < -CORAL_REACH) return;  // Seabed is below the window
+
+    // Each stalk is offset by a fixed angle, so expand sin(phase + offset)
+    // with the tabled offsets and only evaluate trig for the shared phase
+    static const TrigTable& swayOffset = arcTable(CORAL_COUNT, 0.0f, 0.6f * CORAL_COUNT);
+    static const TrigTable& heightOffset = arcTable(CORAL_COUNT, 0.0f, static_cast<float>(CORAL_COUNT));
+    float swaySin = std::sin(coralPhase), swayCos = std::cos(coralPhase);
+    float heightSin = std::sin(coralPhase * 0.8f), heightCos = std::cos(coralPhase * 0.8f);
+
+    float baseHeight = 60.0f;
+    for (int i = 0; i < CORAL_COUNT; ++i) {
+        float x = 40.0f + i * (WINDOW_WIDTH / static_cast<float>(CORAL_COUNT));
+        float sway = (swaySin * swayOffset.cosv[i] + swayCos * swayOffset.sinv[i]) * 8.0f;
+        float height = baseHeight + (heightSin * heightOffset.cosv[i] + heightCos * heightOffset.sinv[i]) * 20.0f;
+
+        // Stalk quad as two triangles, then the lighter tip
+        const float px[CORAL_VERTICES] = {
+            x - 6.0f + sway, x + 6.0f + sway, x + 4.0f,
+            x - 6.0f + sway, x + 4.0f, x - 4.0f,
+            x - 5.0f + sway, x + 5.0f + sway, x + sway
+        };
+        const float py[CORAL_VERTICES] = {
+            0, 0, height,
+            0, height, height,
+            height, height, height + 14.0f
+        };
+        CoralVertex* v = &coral[i * CORAL_VERTICES];
+        for (int k = 0; k < CORAL_VERTICES; ++k) {
+            v[k].x = px[k];
+            v[k].y = py[k];
+        }
+    }
+
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(CoralVertex), &coral[0].x);
+    glColorPointer(4, GL_FLOAT, sizeof(CoralVertex), &coral[0].r);
+    for (int copy = 0; copy < (scrollX > 0.0f ? 2 : 1); ++copy) {
+        glPushMatrix();
+        glTranslatef(copy * WINDOW_WIDTH - scrollX, seabedY, 0.0f);
+        glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(coral.size()));
+        glPopMatrix();
+    }
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisable(GL_BLEND);
+}
@@ -0,0 +1,77 @@
+//
+//  background.h
+//  Fish-Fillet-Project
+//
+//  Cached ocean background. The gradient and both wave rows never change
+//  shape; only a vertical offset (waveDelta) moves the waves. They are
+//  compiled into display lists once and, where the driver allows, the
+//  33 possible wave positions are pre-rendered into a texture atlas so a
+//  frame costs the gradient quad plus one textured quad.
+//
+//  Coral sways continuously, so it cannot be cached as frames; its
+//  vertices sit in a persistent array that is rewritten in place from
+//  coralPhase and drawn with a single glDrawArrays.
+//
+
+#ifndef BACKGROUND_H
+#define BACKGROUND_H
+
+#include <vector>
+
+// Wave animation swings between -MAX_WAVE_DELTA - 1 and +MAX_WAVE_DELTA + 1
+const int MAX_WAVE_DELTA = 15;
+const double WAVE_STEP_SECONDS = 0.02;  // One pixel per step, the old 20 ms frame
+const float CORAL_SWAY_RATE = 1.25f;    // Radians per second
+
+// Animation as a function of time, so it runs at the same speed at any
+// frame rate: the wave offset rises from 0 and bounces between the limits
+int waveOffsetAt(double seconds);
+float coralPhaseAt(double seconds);
+
+enum BackgroundMode {
+    BACKGROUND_LISTS = 0,  // Display lists replayed with a translation
+    BACKGROUND_ATLAS = 1   // Pre-rendered wave frames in a texture
+};
+
+class OceanBackground {
+public:
+    OceanBackground();
+
+    // Ask for a mode; the atlas silently falls back to lists if unsupported
+    void setPreferredMode(BackgroundMode mode) { preferredMode = mode; }
+    BackgroundMode activeMode() const { return mode; }
+
+    // View into an ocean bigger than the window (World::cameraX/Y): the
+    // surface and seabed move with it, and waves and coral repeat every
+    // window width across. At 0, 0 over a window-high ocean nothing moves.
+    void setCamera(float x, float y, float worldHeight);
+
+    // Gradient and waves. Needs a current GL context; builds caches on first use.
+    void drawOcean(int waveDelta);
+
+    // Swaying coral stalks with lighter tips
+    void drawCoral(float coralPhase);
+
+private:
+    struct CoralVertex {
+        float x, y;
+        float r, g, b, a;
+    };
+
+    bool initialized;
+    BackgroundMode preferredMode;
+    BackgroundMode mode;
+    unsigned int gradientList;
+    unsigned int wavesList;
+    unsigned int atlasTexture;
+    std::vector<CoralVertex> coral;
+    float scrollX;      // Camera x within one window width
+    float surfaceY;     // Height of the surface above the top of the ocean band
+    float seabedY;      // Height of the seabed above the bottom of the window
+
+    void init();
+    bool buildAtlas();
+    void drawWaves(int waveDelta);
+};
+
+#endif // BACKGROUND_H
@@ -0,0 +1,305 @@
+//
+//  batch_runner.cpp
+//  Fish-Fillet-Project
+//
+
+#include "batch_runner.h"
+#include "job_system.h"
+#include "world.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+bool setLevelRule(LevelRules& rules, const std::string& key, double value) {
+    float f = static_cast<float>(value);
+    if (key == "fish") rules.fishCount = static_cast<uint32_t>(value);
+    else if (key == "time") rules.initialTime = static_cast<int32_t>(value);
+    else if (key == "player_size") rules.initialPlayerSize = f;
+    else if (key == "max_player_size") rules.maxPlayerSize = f;
+    else if (key == "growth") rules.growthIncrement = f;
+    else if (key == "flee_distance") rules.fleeDistance = f;
+    else if (key == "chase_distance") rules.chaseDistance = f;
+    else if (key == "flee_speed") rules.fleeSpeedMult = f;
+    else if (key == "chase_speed") rules.chaseSpeedMult = f;
+    else if (key == "red_points") rules.redPoints = static_cast<uint16_t>(value);
+    else if (key == "red_growth") rules.redGrowthMult = f;
+    else if (key == "neighbor_radius") rules.neighborRadius = f;
+    else if (key == "separation_radius") rules.separationRadius = f;
+    else if (key == "school_speed") rules.schoolSpeedMult = f;
+    else if (key == "hunt_speed") rules.huntSpeedMult = f;
+    else if (key == "world_width") rules.worldWidth = f;
+    else if (key == "world_height") rules.worldHeight = f;
+    else return false;
+    return true;
+}
+
+static bool parseNumber(const std::string& text, double& value) {
+    char* end = 0;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && end == text.c_str() + text.size();
+}
+
+// Fish counts become a uint32_t, so catch the ones that would wrap before
+// they turn into a round of billions of fish
+static bool validFishCounts(const std::string& spec, const SweepAxis& axis, std::string& error) {
+    if (axis.key != "fish") return true;
+    for (size_t i = 0; i < axis.values.size(); ++i) {
+        if (!(axis.values[i] >= 1.0 && axis.values[i] <= MAX_LEVEL_FISH)) {
+            error = "sweep '" + spec + "': fish counts must be between 1 and 1000000";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseSweepAxis(const std::string& spec, SweepAxis& axis, std::string& error) {
+    size_t equals = spec.find('=');
+    LevelRules scratch = LevelRules();
+    if (equals == std::string::npos || !setLevelRule(scratch, spec.substr(0, equals), 0.0)) {
+        error = "sweep '" + spec + "': expected key=values with a numeric level key such as flee_speed";
+        return false;
+    }
+    axis.key = spec.substr(0, equals);
+    axis.values.clear();
+    std::string list = spec.substr(equals + 1);
+
+    size_t colon = list.find(':');
+    if (colon != std::string::npos) {
+        size_t second = list.find(':', colon + 1);
+        double first, last, step;
+        if (second == std::string::npos || !parseNumber(list.substr(0, colon), first) ||
+            !parseNumber(list.substr(colon + 1, second - colon - 1), last) ||
+            !parseNumber(list.substr(second + 1), step) || !(step > 0.0) || last < first ||
+            (last - first) / step >= MAX_GRID_POINTS) {
+            error = "sweep '" + spec + "': a range is first:last:step with first <= last and step > 0";
+            return false;
+        }
+        // Count steps instead of adding step up, so 0.1 steps do not drift;
+        // the slack keeps last in when the division rounds down
+        long count = static_cast<long>(std::floor((last - first) / step + 1e-6)) + 1;
+        for (long i = 0; i < count; ++i) axis.values.push_back(first + i * step);
+        return validFishCounts(spec, axis, error);
+    }
+
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t comma = list.find(',', start);
+        if (comma == std::string::npos) comma = list.size();
+        double value;
+        if (!parseNumber(list.substr(start, comma - start), value)) {
+            error = "sweep '" + spec + "': bad value '" + list.substr(start, comma - start) + "'";
+            return false;
+        }
+        axis.values.push_back(value);
+        start = comma + 1;
+    }
+    return validFishCounts(spec, axis, error);
+}
+
+BatchRunner::BatchRunner(JobSystem* jobs) : jobs(jobs) {}
+
+// Every combination of axis values, the last axis changing fastest
+bool BatchRunner::buildGrid(std::string& error) {
+    size_t axisCount = config.axes.size();
+    size_t points = 1;
+    for (size_t a = 0; a < axisCount; ++a) {
+        points *= config.axes[a].values.size();
+        if (points == 0 || points > MAX_GRID_POINTS) {
+            error = "sweep grid must have between 1 and 100000 points";
+            return false;
+        }
+    }
+
+    levels.clear();
+    values.assign(points * axisCount, 0.0);
+    for (size_t p = 0; p < points; ++p) {
+        LevelRules rules = config.level->rules;
+        size_t rest = p;
+        for (size_t a = axisCount; a-- > 0; ) {
+            const SweepAxis& axis = config.axes[a];
+            double value = axis.values[rest % axis.values.size()];
+            rest /= axis.values.size();
+            setLevelRule(rules, axis.key, value);
+            values[p * axisCount + a] = value;
+        }
+        std::shared_ptr<const Level> level = axisCount ? config.level->withRules(rules, error) : config.level;
+        if (!level) {
+            error = "sweep point " + std::to_string(p) + ": " + error;
+            return false;
+        }
+        levels.push_back(level);
+    }
+    return true;
+}
+
+bool BatchRunner::run(const BatchConfig& batch, std::string& error) {
+    config = batch;
+    if (!config.level) config.level = defaultLevel();
+    if (config.sessions < 1) {
+        error = "a batch needs at least one round per point";
+        return false;
+    }
+    for (size_t a = 0; a < config.axes.size(); ++a) {
+        LevelRules scratch = LevelRules();
+        if (!setLevelRule(scratch, config.axes[a].key, 0.0)) {
+            error = "cannot sweep '" + config.axes[a].key + "'";
+            return false;
+        }
+    }
+    if (!buildGrid(error)) return false;
+
+    size_t count = levels.size() * config.sessions;
+    results.assign(count, RoundResult());
+    if (jobs) {
+        auto play = [this](size_t, size_t begin, size_t end) { playRounds(begin, end); };
+        jobs->parallelFor(count, BATCH_CHUNK_ROUNDS, play);
+    } else {
+        for (size_t begin = 0; begin < count; begin += BATCH_CHUNK_ROUNDS) {
+            playRounds(begin, std::min(count, begin + BATCH_CHUNK_ROUNDS));
+        }
+    }
+    return true;
+}
+
+// Play rounds [begin, end) of the batch, numbered point-major
+// Each thread keeps one World for every chunk it plays, in this batch and
+// later ones, so once its storage has grown to the largest grid point a
+// round allocates nothing
+void BatchRunner::playRounds(size_t begin, size_t end) {
+    thread_local World world;
+    BotPlayer bot(config.bot);
+    size_t sessionsPerPoint = static_cast<size_t>(config.sessions);
+    for (size_t r = begin; r < end; ++r) {
+        size_t session = r % sessionsPerPoint;
+        world.level = levels[r / sessionsPerPoint];  // reset() picks up the rules
+
+        // The s-th seed World::reset() would draw after seedRounds(seed)
+        uint64_t sequence = config.seed + session * 0x9E3779B97F4A7C15ULL;
+        RoundResult& out = results[r];
+        out.seed = nextSeed(sequence);
+        out.eaten = 0;
+
+        world.player = Fish(true);  // Every round starts from the middle
+        world.reset(out.seed);
+        bot.reset(world);
+        while (!world.isGameOver) {
+            bot.steer(world);
+            world.tick();
+            for (size_t e = 0; e < world.events.size(); ++e) {
+                if (world.events[e] == EVENT_FISH_EATEN) ++out.eaten;
+            }
+            world.events.clear();
+        }
+        out.ticks = static_cast<int32_t>(world.tickCount);
+        out.score = world.score;
+        out.playerSize = world.playerSizeScale;
+        out.outcome = static_cast<uint8_t>(world.allYellowFishGone ? ROUND_WON :
+                                           world.gameTime == 0 ? ROUND_TIME_UP : ROUND_HIT);
+    }
+}
+
+// Nearest-rank percentile of sorted values
+template <class T>
+static T percentile(const std::vector<T>& sorted, double q) {
+    size_t rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+PointSummary BatchRunner::summarize(size_t p) const {
+    PointSummary s = PointSummary();
+    const RoundResult* round = rounds(p);
+    std::vector<double> winSeconds;
+    std::vector<int> scores;
+    double scoreSum = 0.0, scoreSquares = 0.0, eatenSum = 0.0;
+    for (int i = 0; i < config.sessions; ++i) {
+        const RoundResult& r = round[i];
+        if (r.outcome == ROUND_WON) {
+            ++s.wins;
+            winSeconds.push_back(r.ticks * static_cast<double>(SIM_DT));
+        } else if (r.outcome == ROUND_HIT) {
+            ++s.hits;
+        } else {
+            ++s.timeUps;
+        }
+        scores.push_back(r.score);
+        scoreSum += r.score;
+        scoreSquares += static_cast<double>(r.score) * r.score;
+        eatenSum += r.eaten;
+    }
+    s.rounds = config.sessions;
+    s.winRate = double(s.wins) / s.rounds;
+    s.scoreMean = scoreSum / s.rounds;
+    s.scoreStddev = std::sqrt(std::max(0.0, scoreSquares / s.rounds - s.scoreMean * s.scoreMean));
+    s.eatenMean = eatenSum / s.rounds;
+
+    std::sort(scores.begin(), scores.end());
+    s.scoreP10 = percentile(scores, 0.10);
+    s.scoreP50 = percentile(scores, 0.50);
+    s.scoreP90 = percentile(scores, 0.90);
+    s.scoreMax = scores.back();
+
+    s.winSecondsMean = s.winSecondsP50 = s.winSecondsP90 = std::numeric_limits<double>::quiet_NaN();
+    if (!winSeconds.empty()) {
+        std::sort(winSeconds.begin(), winSeconds.end());
+        double sum = 0.0;
+        for (size_t i = 0; i < winSeconds.size(); ++i) sum += winSeconds[i];
+        s.winSecondsMean = sum / winSeconds.size();
+        s.winSecondsP50 = percentile(winSeconds, 0.50);
+        s.winSecondsP90 = percentile(winSeconds, 0.90);
+    }
+    return s;
+}
+
+long BatchRunner::totalTicks() const {
+    long ticks = 0;
+    for (size_t i = 0; i < results.size(); ++i) ticks += results[i].ticks;
+    return ticks;
+}
+
+void BatchRunner::writeValues(std::FILE* f, size_t p) const {
+    const double* v = pointValues(p);
+    for (size_t a = 0; a < config.axes.size(); ++a) std::fprintf(f, "%g,", v[a]);
+}
+
+// Empty field for a missing (NaN) value, so spreadsheets see a blank
+static void writeSeconds(std::FILE* f, double seconds) {
+    if (seconds == seconds) std::fprintf(f, "%.2f", seconds);
+}
+
+void BatchRunner::writeSummaryCsv(std::FILE* f) const {
+    for (size_t a = 0; a < config.axes.size(); ++a) std::fprintf(f, "%s,", config.axes[a].key.c_str());
+    std::fprintf(f, "bot,rounds,wins,hits,time_ups,win_rate,win_time_mean,win_time_p50,win_time_p90,"
+                    "score_mean,score_stddev,score_p10,score_p50,score_p90,score_max,eaten_mean\n");
+    for (size_t p = 0; p < pointCount(); ++p) {
+        PointSummary s = summarize(p);
+        writeValues(f, p);
+        std::fprintf(f, "%s,%d,%d,%d,%d,%.4f,", botName(config.bot), s.rounds, s.wins, s.hits, s.timeUps,
+                     s.winRate);
+        writeSeconds(f, s.winSecondsMean);
+        std::fputc(',', f);
+        writeSeconds(f, s.winSecondsP50);
+        std::fputc(',', f);
+        writeSeconds(f, s.winSecondsP90);
+        std::fprintf(f, ",%.3f,%.3f,%d,%d,%d,%d,%.3f\n", s.scoreMean, s.scoreStddev, s.scoreP10, s.scoreP50,
+                     s.scoreP90, s.scoreMax, s.eatenMean);
+    }
+}
+
+void BatchRunner::writeRoundsCsv(std::FILE* f) const {
+    static const char* const outcomes[] = {"won", "hit", "time_up"};
+    std::fprintf(f, "point,");
+    for (size_t a = 0; a < config.axes.size(); ++a) std::fprintf(f, "%s,", config.axes[a].key.c_str());
+    std::fprintf(f, "session,seed,outcome,seconds,score,eaten,player_size\n");
+    for (size_t p = 0; p < pointCount(); ++p) {
+        const RoundResult* round = rounds(p);
+        for (int i = 0; i < config.sessions; ++i) {
+            const RoundResult& r = round[i];
+            std::fprintf(f, "%zu,", p);
+            writeValues(f, p);
+            std::fprintf(f, "%d,%llu,%s,%.2f,%d,%d,%.3f\n", i, static_cast<unsigned long long>(r.seed),
+                         outcomes[r.outcome], r.ticks * static_cast<double>(SIM_DT), r.score, r.eaten,
+                         r.playerSize);
+        }
+    }
+}
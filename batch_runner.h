@@ -0,0 +1,130 @@
+//
+//  batch_runner.h
+//  Fish-Fillet-Project
+//
+//  Plays many rounds with a bot at the controls and no window, to tune
+//  difficulty from numbers instead of by feel. A batch takes a base level
+//  and a grid of rule overrides (every combination of the values given for
+//  each swept key) and plays the same number of rounds at every grid point.
+//  Session s uses the same seed at every point, so points are compared on
+//  identical oceans, and a parked bot on a one-point grid replays exactly
+//  the rounds --headless plays for that --seed.
+//
+//  Rounds are dealt to the job pool in chunks of BATCH_CHUNK_ROUNDS; each
+//  chunk plays its rounds one after another in its thread's World, which
+//  every round resets. Results
+//  land in a slot per round, so a batch gives the same numbers, down to the
+//  last digit, on any number of threads.
+//
+
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include "bot_player.h"
+#include "level.h"
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+class JobSystem;
+
+const size_t BATCH_CHUNK_ROUNDS = 8;
+const size_t MAX_GRID_POINTS = 100000;
+
+// One level rule to vary, by its key in the level text format
+struct SweepAxis {
+    std::string key;
+    std::vector<double> values;
+};
+
+// Parse "key=v1,v2,..." or "key=first:last:step" (last included). Only
+// single-number keys can be swept; see setLevelRule.
+bool parseSweepAxis(const std::string& spec, SweepAxis& axis, std::string& error);
+
+// Set the rule a level file writes as "key value". False for keys that are
+// not a single number (species, school, place, name, red).
+bool setLevelRule(LevelRules& rules, const std::string& key, double value);
+
+enum RoundOutcome {
+    ROUND_WON = 0,      // Every fish eaten
+    ROUND_HIT = 1,      // Touched a fish too big to eat
+    ROUND_TIME_UP = 2
+};
+
+struct RoundResult {
+    uint64_t seed;
+    int32_t ticks;          // Until the round ended
+    int32_t score;
+    int32_t eaten;          // Fish the player ate (fish eaten by fish not counted)
+    float playerSize;       // Growth scale at the end
+    uint8_t outcome;        // RoundOutcome
+};
+
+struct BatchConfig {
+    std::shared_ptr<const Level> level;     // Base rules; axes override them
+    std::vector<SweepAxis> axes;
+    int sessions;                           // Rounds per grid point
+    BotKind bot;
+    uint64_t seed;                          // Master seed, as for --headless
+
+    BatchConfig() : sessions(100), bot(BOT_GREEDY), seed(1) {}
+};
+
+// Aggregates over one grid point's rounds. Times are game-clock seconds;
+// the win-time fields are NaN when no round was won.
+struct PointSummary {
+    int rounds;
+    int wins, hits, timeUps;
+    double winRate;
+    double winSecondsMean, winSecondsP50, winSecondsP90;
+    double scoreMean, scoreStddev;
+    int scoreP10, scoreP50, scoreP90, scoreMax;
+    double eatenMean;
+};
+
+class BatchRunner {
+public:
+    // Rounds run on jobs when given, otherwise on the calling thread
+    explicit BatchRunner(JobSystem* jobs = 0);
+
+    // Build the grid and play every round. False, with error set, if a
+    // key cannot be swept or a grid point's rules would not load.
+    bool run(const BatchConfig& config, std::string& error);
+
+    size_t pointCount() const { return levels.size(); }
+    int sessions() const { return config.sessions; }
+
+    // Swept values of grid point p, one per axis, in axis order
+    const double* pointValues(size_t p) const { return &values[p * config.axes.size()]; }
+
+    // The sessions() rounds played at grid point p, in session order
+    const RoundResult* rounds(size_t p) const { return &results[p * config.sessions]; }
+
+    PointSummary summarize(size_t p) const;
+    long totalTicks() const;
+
+    // One row per grid point: the swept values, then outcome rates, time to
+    // win and score percentiles
+    void writeSummaryCsv(std::FILE* f) const;
+
+    // One row per round, for histograms
+    void writeRoundsCsv(std::FILE* f) const;
+
+private:
+    JobSystem* jobs;
+    BatchConfig config;
+    std::vector<std::shared_ptr<const Level> > levels;  // One per grid point
+    std::vector<double> values;                         // axes.size() per point
+    std::vector<RoundResult> results;                   // sessions per point
+
+    bool buildGrid(std::string& error);
+    void playRounds(size_t begin, size_t end);
+    void writeValues(std::FILE* f, size_t p) const;
+
+    BatchRunner(const BatchRunner&);
+    BatchRunner& operator=(const BatchRunner&);
+};
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,320 @@
+//
+//  behavior_kernel.cpp
+//  Fish-Fillet-Project
+//
+
+#include "behavior_kernel.h"
+#include "job_system.h"
+#include <cmath>
+
+#if !defined(FISH_KERNEL_SCALAR) && defined(__AVX__)
+#include <immintrin.h>
+#define FISH_KERNEL_AVX 1
+#elif !defined(FISH_KERNEL_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define FISH_KERNEL_SSE2 1
+#endif
+
+void steerFishScalar(FishStore& fish, size_t begin, size_t end,
+                     float playerX, float playerY, float playerRadius, const BehaviorParams& params,
+                     const float* driftX, const float* driftY) {
+    float* xs = fish.x.data();
+    float* ys = fish.y.data();
+    float* dirs = fish.direction.data();
+    const float* scales = fish.sizeScale.data();
+    const unsigned char* reds = fish.isRedFish.data();
+    const unsigned char* types = fish.species.data();
+
+    for (size_t i = begin; i < end; ++i) {
+        float dx = playerX - xs[i];
+        float dy = playerY - ys[i];
+        float dist2 = dx * dx + dy * dy;
+        float myRadius = COLLISION_RADIUS * scales[i];
+
+        // Default drift, along `direction` unless the flock pass set one
+        float stepX = driftX ? driftX[i] : dirs[i];
+        float stepY = driftY ? driftY[i] : 0.0f;
+
+        if (playerRadius > myRadius * 0.9f && dist2 < params.fleeDistance2) {
+            float norm = std::sqrt(dist2) + 0.001f;
+            stepX = -(dx / norm) * FISH_SPEED * params.fleeSpeedMult * 2.0f;
+            stepY = -(dy / norm) * FISH_SPEED * params.fleeSpeedMult * 2.0f;
+            dirs[i] = (stepX < 0) ? -FISH_SPEED : FISH_SPEED;
+        } else if ((reds[i] || params.chases[types[i]]) && playerRadius < myRadius * 0.95f && dist2 < params.chaseDistance2) {
+            float norm = std::sqrt(dist2) + 0.001f;
+            stepX = (dx / norm) * FISH_SPEED * params.chaseSpeedMult * 2.0f;
+            stepY = (dy / norm) * FISH_SPEED * params.chaseSpeedMult * 2.0f;
+            dirs[i] = (stepX < 0) ? -FISH_SPEED : FISH_SPEED;
+        } else {
+            // Face the way the drift goes, keeping the drift speed
+            float speed = std::fabs(dirs[i]);
+            dirs[i] = (stepX < 0) ? -speed : speed;
+        }
+
+        xs[i] += stepX;
+        ys[i] += stepY;
+    }
+}
+
+#if defined(FISH_KERNEL_AVX)
+
+// Build a lane mask from the byte-sized red flags and the species' chase
+// flags: look the species up with a byte shuffle (chaseTable holds chases[]
+// in its low MAX_SPECIES bytes) and widen the bytes to lanes. Filling the
+// lanes one fish at a time cost more than the rest of the update.
+static inline __m256 chaserMask8(const unsigned char* reds, const unsigned char* types, __m128i chaseTable) {
+    __m128i red = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(reds));
+    __m128i chases = _mm_shuffle_epi8(chaseTable, _mm_loadl_epi64(reinterpret_cast<const __m128i*>(types)));
+    __m128i calm = _mm_cmpeq_epi8(_mm_or_si128(red, chases), _mm_setzero_si128());
+    __m128i chaser = _mm_xor_si128(calm, _mm_set1_epi32(-1));
+    __m256i lanes = _mm256_insertf128_si256(_mm256_castsi128_si256(_mm_cvtepi8_epi32(chaser)),
+                                            _mm_cvtepi8_epi32(_mm_srli_si128(chaser, 4)), 1);
+    return _mm256_castsi256_ps(lanes);
+}
+
+void steerFishSimd(FishStore& fish, size_t begin, size_t end,
+                   float playerX, float playerY, float playerRadius, const BehaviorParams& params,
+                   const float* driftX, const float* driftY) {
+    float* xs = fish.x.data();
+    float* ys = fish.y.data();
+    float* dirs = fish.direction.data();
+    const float* scales = fish.sizeScale.data();
+    const unsigned char* reds = fish.isRedFish.data();
+    const unsigned char* types = fish.species.data();
+
+    const __m256 px = _mm256_set1_ps(playerX);
+    const __m256 py = _mm256_set1_ps(playerY);
+    const __m256 pr = _mm256_set1_ps(playerRadius);
+    const __m256 radius = _mm256_set1_ps(COLLISION_RADIUS);
+    const __m256 fleeRatio = _mm256_set1_ps(0.9f);
+    const __m256 chaseRatio = _mm256_set1_ps(0.95f);
+    const __m256 fleeDist2 = _mm256_set1_ps(params.fleeDistance2);
+    const __m256 chaseDist2 = _mm256_set1_ps(params.chaseDistance2);
+    const __m256 epsilon = _mm256_set1_ps(0.001f);
+    const __m256 speed = _mm256_set1_ps(FISH_SPEED);
+    const __m256 negSpeed = _mm256_set1_ps(-FISH_SPEED);
+    const __m256 fleeMult = _mm256_set1_ps(params.fleeSpeedMult);
+    const __m256 chaseMult = _mm256_set1_ps(params.chaseSpeedMult);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    const __m256 zero = _mm256_setzero_ps();
+    alignas(16) unsigned char chaseBytes[16] = {0};
+    for (int s = 0; s < MAX_SPECIES; ++s) chaseBytes[s] = params.chases[s];
+    const __m128i chaseTable = _mm_load_si128(reinterpret_cast<const __m128i*>(chaseBytes));
+
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m256 x = _mm256_loadu_ps(xs + i);
+        __m256 y = _mm256_loadu_ps(ys + i);
+        __m256 dir = _mm256_loadu_ps(dirs + i);
+        __m256 dx = _mm256_sub_ps(px, x);
+        __m256 dy = _mm256_sub_ps(py, y);
+        __m256 dist2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+        __m256 myRadius = _mm256_mul_ps(radius, _mm256_loadu_ps(scales + i));
+
+        __m256 flee = _mm256_and_ps(_mm256_cmp_ps(pr, _mm256_mul_ps(myRadius, fleeRatio), _CMP_GT_OQ),
+                                    _mm256_cmp_ps(dist2, fleeDist2, _CMP_LT_OQ));
+        __m256 chase = _mm256_and_ps(chaserMask8(reds + i, types + i, chaseTable),
+                       _mm256_and_ps(_mm256_cmp_ps(pr, _mm256_mul_ps(myRadius, chaseRatio), _CMP_LT_OQ),
+                                     _mm256_cmp_ps(dist2, chaseDist2, _CMP_LT_OQ)));
+        chase = _mm256_andnot_ps(flee, chase);
+        __m256 steering = _mm256_or_ps(flee, chase);
+
+        __m256 stepX = driftX ? _mm256_loadu_ps(driftX + i) : dir;
+        __m256 stepY = driftY ? _mm256_loadu_ps(driftY + i) : zero;
+        __m256 driftSpeed = _mm256_andnot_ps(signBit, dir);
+        __m256 finalDir = _mm256_blendv_ps(driftSpeed, _mm256_xor_ps(driftSpeed, signBit),
+                                           _mm256_cmp_ps(stepX, zero, _CMP_LT_OQ));
+        if (_mm256_movemask_ps(steering)) {
+            __m256 norm = _mm256_add_ps(_mm256_sqrt_ps(dist2), epsilon);
+            __m256 ux = _mm256_div_ps(dx, norm);
+            __m256 uy = _mm256_div_ps(dy, norm);
+            __m256 fleeX = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_xor_ps(ux, signBit), speed), fleeMult), two);
+            __m256 fleeY = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(_mm256_xor_ps(uy, signBit), speed), fleeMult), two);
+            __m256 chaseX = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(ux, speed), chaseMult), two);
+            __m256 chaseY = _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(uy, speed), chaseMult), two);
+            stepX = _mm256_blendv_ps(stepX, fleeX, flee);
+            stepY = _mm256_blendv_ps(stepY, fleeY, flee);
+            stepX = _mm256_blendv_ps(stepX, chaseX, chase);
+            stepY = _mm256_blendv_ps(stepY, chaseY, chase);
+            __m256 newDir = _mm256_blendv_ps(speed, negSpeed, _mm256_cmp_ps(stepX, zero, _CMP_LT_OQ));
+            finalDir = _mm256_blendv_ps(finalDir, newDir, steering);
+        }
+        _mm256_storeu_ps(dirs + i, finalDir);
+
+        _mm256_storeu_ps(xs + i, _mm256_add_ps(x, stepX));
+        _mm256_storeu_ps(ys + i, _mm256_add_ps(y, stepY));
+    }
+    steerFishScalar(fish, i, end, playerX, playerY, playerRadius, params, driftX, driftY);
+}
+
+const char* behaviorKernelName() { return "avx"; }
+
+#elif defined(FISH_KERNEL_SSE2)
+
+// SSE2 has no blendv; select with and/andnot/or
+static inline __m128 select4(__m128 a, __m128 b, __m128 mask) {
+    return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b));
+}
+
+static inline __m128 chaserMask4(const unsigned char* reds, const unsigned char* types,
+                                 const unsigned char* chases) {
+    return _mm_castsi128_ps(_mm_set_epi32(
+        (reds[3] || chases[types[3]]) ? -1 : 0,
+        (reds[2] || chases[types[2]]) ? -1 : 0,
+        (reds[1] || chases[types[1]]) ? -1 : 0,
+        (reds[0] || chases[types[0]]) ? -1 : 0));
+}
+
+void steerFishSimd(FishStore& fish, size_t begin, size_t end,
+                   float playerX, float playerY, float playerRadius, const BehaviorParams& params,
+                   const float* driftX, const float* driftY) {
+    float* xs = fish.x.data();
+    float* ys = fish.y.data();
+    float* dirs = fish.direction.data();
+    const float* scales = fish.sizeScale.data();
+    const unsigned char* reds = fish.isRedFish.data();
+    const unsigned char* types = fish.species.data();
+
+    const __m128 px = _mm_set1_ps(playerX);
+    const __m128 py = _mm_set1_ps(playerY);
+    const __m128 pr = _mm_set1_ps(playerRadius);
+    const __m128 radius = _mm_set1_ps(COLLISION_RADIUS);
+    const __m128 fleeRatio = _mm_set1_ps(0.9f);
+    const __m128 chaseRatio = _mm_set1_ps(0.95f);
+    const __m128 fleeDist2 = _mm_set1_ps(params.fleeDistance2);
+    const __m128 chaseDist2 = _mm_set1_ps(params.chaseDistance2);
+    const __m128 epsilon = _mm_set1_ps(0.001f);
+    const __m128 speed = _mm_set1_ps(FISH_SPEED);
+    const __m128 negSpeed = _mm_set1_ps(-FISH_SPEED);
+    const __m128 fleeMult = _mm_set1_ps(params.fleeSpeedMult);
+    const __m128 chaseMult = _mm_set1_ps(params.chaseSpeedMult);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128 zero = _mm_setzero_ps();
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 dir = _mm_loadu_ps(dirs + i);
+        __m128 dx = _mm_sub_ps(px, x);
+        __m128 dy = _mm_sub_ps(py, y);
+        __m128 dist2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+        __m128 myRadius = _mm_mul_ps(radius, _mm_loadu_ps(scales + i));
+
+        __m128 flee = _mm_and_ps(_mm_cmpgt_ps(pr, _mm_mul_ps(myRadius, fleeRatio)),
+                                 _mm_cmplt_ps(dist2, fleeDist2));
+        __m128 chase = _mm_and_ps(chaserMask4(reds + i, types + i, params.chases),
+                       _mm_and_ps(_mm_cmplt_ps(pr, _mm_mul_ps(myRadius, chaseRatio)),
+                                  _mm_cmplt_ps(dist2, chaseDist2)));
+        chase = _mm_andnot_ps(flee, chase);
+        __m128 steering = _mm_or_ps(flee, chase);
+
+        __m128 stepX = driftX ? _mm_loadu_ps(driftX + i) : dir;
+        __m128 stepY = driftY ? _mm_loadu_ps(driftY + i) : zero;
+        __m128 driftSpeed = _mm_andnot_ps(signBit, dir);
+        __m128 finalDir = select4(driftSpeed, _mm_xor_ps(driftSpeed, signBit), _mm_cmplt_ps(stepX, zero));
+        if (_mm_movemask_ps(steering)) {
+            __m128 norm = _mm_add_ps(_mm_sqrt_ps(dist2), epsilon);
+            __m128 ux = _mm_div_ps(dx, norm);
+            __m128 uy = _mm_div_ps(dy, norm);
+            __m128 fleeX = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_xor_ps(ux, signBit), speed), fleeMult), two);
+            __m128 fleeY = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(_mm_xor_ps(uy, signBit), speed), fleeMult), two);
+            __m128 chaseX = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(ux, speed), chaseMult), two);
+            __m128 chaseY = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(uy, speed), chaseMult), two);
+            stepX = select4(stepX, fleeX, flee);
+            stepY = select4(stepY, fleeY, flee);
+            stepX = select4(stepX, chaseX, chase);
+            stepY = select4(stepY, chaseY, chase);
+            __m128 newDir = select4(speed, negSpeed, _mm_cmplt_ps(stepX, zero));
+            finalDir = select4(finalDir, newDir, steering);
+        }
+        _mm_storeu_ps(dirs + i, finalDir);
+
+        _mm_storeu_ps(xs + i, _mm_add_ps(x, stepX));
+        _mm_storeu_ps(ys + i, _mm_add_ps(y, stepY));
+    }
+    steerFishScalar(fish, i, end, playerX, playerY, playerRadius, params, driftX, driftY);
+}
+
+const char* behaviorKernelName() { return "sse2"; }
+
+#else
+
+void steerFishSimd(FishStore& fish, size_t begin, size_t end,
+                   float playerX, float playerY, float playerRadius, const BehaviorParams& params,
+                   const float* driftX, const float* driftY) {
+    steerFishScalar(fish, begin, end, playerX, playerY, playerRadius, params, driftX, driftY);
+}
+
+const char* behaviorKernelName() { return "scalar"; }
+
+#endif
+
+void wrapAndClampFish(FishStore& fish, size_t begin, size_t end, const BehaviorParams& params, Rng& rng) {
+    float* xs = fish.x.data();
+    float* ys = fish.y.data();
+    const float width = params.worldWidth;
+    const int depth = static_cast<int>(params.worldHeight);
+    const float surface = params.worldHeight - 30;
+    for (size_t i = begin; i < end; ++i) {
+        // Wrap horizontally
+        if (xs[i] > width) {
+            xs[i] -= width;
+            ys[i] = static_cast<float>(rng.nextInt(depth));
+        }
+        if (xs[i] < 0) {
+            xs[i] += width;
+            ys[i] = static_cast<float>(rng.nextInt(depth));
+        }
+
+        // Clamp vertical movement to stay in ocean
+        if (ys[i] < 40) ys[i] = 40;
+        if (ys[i] > surface) ys[i] = surface;
+    }
+}
+
+// Clamp the fish in [begin, end) that stayed on screen. Fish that left get a
+// fresh row from wrapAndClampFish, so whatever happens to their y here is
+// overwritten; only the rng draws have to stay serial.
+static void clampOnScreenFish(FishStore& fish, size_t begin, size_t end, const BehaviorParams& params) {
+    const float* xs = fish.x.data();
+    float* ys = fish.y.data();
+    const float surface = params.worldHeight - 30;
+    for (size_t i = begin; i < end; ++i) {
+        if (xs[i] > params.worldWidth || xs[i] < 0) continue;
+        if (ys[i] < 40) ys[i] = 40;
+        if (ys[i] > surface) ys[i] = surface;
+    }
+}
+
+// Serial tail of the parallel update: wrap the fish that left the screen,
+// drawing rows from rng in index order exactly like the serial loop
+static void wrapOffScreenFish(FishStore& fish, const BehaviorParams& params, Rng& rng) {
+    const float* xs = fish.x.data();
+    for (size_t i = 0, n = fish.size(); i < n; ++i) {
+        if (xs[i] > params.worldWidth || xs[i] < 0) {
+            wrapAndClampFish(fish, i, i + 1, params, rng);
+        }
+    }
+}
+
+void updateFishBehavior(FishStore& fish, float playerX, float playerY, float playerRadius,
+                        const BehaviorParams& params, const float* driftX, const float* driftY,
+                        Rng& rng, JobSystem* jobs) {
+    size_t count = fish.size();
+    if (!jobs || jobs->threadCount() < 2 || count < PARALLEL_BEHAVIOR_MIN_FISH) {
+        steerFishSimd(fish, 0, count, playerX, playerY, playerRadius, params, driftX, driftY);
+        wrapAndClampFish(fish, 0, count, params, rng);
+        return;
+    }
+
+    // Every fish only reads the player, so chunks are independent
+    auto steerChunk = [&](size_t, size_t begin, size_t end) {
+        steerFishSimd(fish, begin, end, playerX, playerY, playerRadius, params, driftX, driftY);
+        clampOnScreenFish(fish, begin, end, params);
+    };
+    jobs->parallelFor(count, BEHAVIOR_CHUNK_SIZE, steerChunk);
+    wrapOffScreenFish(fish, params, rng);
+}
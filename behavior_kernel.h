@@ -0,0 +1,53 @@
+//
+//  behavior_kernel.h
+//  Fish-Fillet-Project
+//
+//  Batched flee/chase/drift/wrap/clamp update over a FishStore. The SIMD
+//  paths evaluate exactly the same float operations, in the same order, as
+//  the scalar loop (and, without flock drift, Fish::moveWithBehavior), so
+//  every build produces bit-identical positions.
+//  Define FISH_KERNEL_SCALAR to force the plain loop. Builds that enable FMA
+//  (-mfma, -march=native) must also pass -ffp-contract=off, otherwise the
+//  compiler fuses the scalar multiply-adds and the paths drift apart.
+//
+
+#ifndef BEHAVIOR_KERNEL_H
+#define BEHAVIOR_KERNEL_H
+
+#include "fish_store.h"
+#include "level.h"
+
+class JobSystem;
+
+// Oceans smaller than this update on the calling thread; below a few
+// thousand fish waking the pool costs more than the whole update
+const size_t PARALLEL_BEHAVIOR_MIN_FISH = 8192;
+const size_t BEHAVIOR_CHUNK_SIZE = 2048;  // Fish per job, a multiple of the SIMD width
+
+// Steer and integrate fish [begin, end) with the level's behavior tuning.
+// Fish that do not react to the player move by (driftX[i], driftY[i]) and
+// turn to face that way; with null drift arrays they drift along
+// `direction`. Does not wrap or clamp.
+void steerFishScalar(FishStore& fish, size_t begin, size_t end,
+                     float playerX, float playerY, float playerRadius, const BehaviorParams& params,
+                     const float* driftX = 0, const float* driftY = 0);
+void steerFishSimd(FishStore& fish, size_t begin, size_t end,
+                   float playerX, float playerY, float playerRadius, const BehaviorParams& params,
+                   const float* driftX = 0, const float* driftY = 0);
+
+// Wrap fish that swam off either side of the world (drawing a new row from
+// rng in index order) and clamp everyone between seabed and surface.
+void wrapAndClampFish(FishStore& fish, size_t begin, size_t end, const BehaviorParams& params, Rng& rng);
+
+// Full behavior update for every fish in the store. With a job system and a
+// large enough ocean, steering and clamping run in parallel chunks and only
+// the wrap (which draws from rng) runs serially in index order, so the
+// result is identical to the single-threaded update.
+void updateFishBehavior(FishStore& fish, float playerX, float playerY, float playerRadius,
+                        const BehaviorParams& params, const float* driftX, const float* driftY,
+                        Rng& rng, JobSystem* jobs = 0);
+
+// Name of the vector path compiled in ("avx", "sse2" or "scalar")
+const char* behaviorKernelName();
+
+#endif // BEHAVIOR_KERNEL_H
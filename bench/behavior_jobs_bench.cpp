@@ -0,0 +1,78 @@
+//
+//  behavior_jobs_bench.cpp
+//  Fish-Fillet-Project
+//
+//  Fish behavior update on one thread against the job system as the ocean
+//  grows, and a check that both produce bit-identical fish after many
+//  ticks (including the rng-driven wraps).
+//
+//  g++ -O2 -pthread -I. bench/behavior_jobs_bench.cpp behavior_kernel.cpp fish.cpp fish_store.cpp job_system.cpp level.cpp -o behavior_jobs_bench
+//  ./behavior_jobs_bench [threads]
+//
+
+#include "behavior_kernel.h"
+#include "job_system.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static void fillOcean(FishStore& fish, int n) {
+    Rng rng(1234);
+    fish.clear();
+    fish.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        Fish f(rng, defaultLevel()->rules);
+        f.x = static_cast<float>(rng.nextInt(WINDOW_WIDTH));
+        f.y = static_cast<float>(40 + rng.nextInt(OCEAN_HEIGHT - 70));
+        fish.push(f);
+    }
+}
+
+static bool sameFish(const FishStore& a, const FishStore& b) {
+    size_t bytes = a.size() * sizeof(float);
+    return a.size() == b.size() &&
+           std::memcmp(a.x.data(), b.x.data(), bytes) == 0 &&
+           std::memcmp(a.y.data(), b.y.data(), bytes) == 0 &&
+           std::memcmp(a.direction.data(), b.direction.data(), bytes) == 0;
+}
+
+// Optional argument: total threads (default: one per hardware thread)
+int main(int argc, char* argv[]) {
+    const int counts[] = {20, 10000, 100000, 1000000};
+    int threads = argc > 1 ? std::atoi(argv[1]) : 0;
+    JobSystem jobs(threads > 1 ? threads - 1 : 0);
+    BehaviorParams params = behaviorParams(defaultLevel()->rules);
+
+    std::printf("kernel: %s  threads: %u\n", behaviorKernelName(), jobs.threadCount());
+    std::printf("%8s %12s %12s %9s %10s\n", "fish", "serial us", "jobs us", "speedup", "identical");
+
+    for (int n : counts) {
+        FishStore serial, parallel;
+        fillOcean(serial, n);
+        fillOcean(parallel, n);
+        Rng serialRng(99), parallelRng(99);
+        int ticks = n >= 100000 ? 50 : 500;
+
+        // Sweep the player across the ocean so fish flee, chase and wrap
+        Clock::time_point t0 = Clock::now();
+        for (int t = 0; t < ticks; ++t) {
+            updateFishBehavior(serial, float(t * 7 % WINDOW_WIDTH), 250.0f, 20.0f, params, 0, 0, serialRng);
+        }
+        std::chrono::duration<double, std::micro> serialUs = Clock::now() - t0;
+
+        t0 = Clock::now();
+        for (int t = 0; t < ticks; ++t) {
+            updateFishBehavior(parallel, float(t * 7 % WINDOW_WIDTH), 250.0f, 20.0f, params, 0, 0, parallelRng, &jobs);
+        }
+        std::chrono::duration<double, std::micro> jobsUs = Clock::now() - t0;
+
+        std::printf("%8d %12.1f %12.1f %8.2fx %10s\n", n, serialUs.count() / ticks, jobsUs.count() / ticks,
+                    serialUs.count() / jobsUs.count(),
+                    sameFish(serial, parallel) && serialRng.next() == parallelRng.next() ? "yes" : "NO");
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+//
+//  benchmark_baseline.cpp
+//  Fish-Fillet-Project
+//
+
+#include "benchmark_baseline.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+static bool compared(bool aggregate, const std::string& aggregateName) {
+    return !aggregate || aggregateName == "median";
+}
+
+static double toNanoseconds(double value, const std::string& unit) {
+    if (unit == "us") return value * 1e3;
+    if (unit == "ms") return value * 1e6;
+    if (unit == "s") return value * 1e9;
+    return value;
+}
+
+void RecordingReporter::ReportRuns(const std::vector<Run>& runs) {
+    for (size_t i = 0; i < runs.size(); ++i) {
+        const Run& run = runs[i];
+        if (!compared(run.run_type == Run::RT_Aggregate, run.aggregate_name)) continue;
+        double perSecond = benchmark::GetTimeUnitMultiplier(run.time_unit);
+        cpuNs[run.benchmark_name()] = run.GetAdjustedCPUTime() * 1e9 / perSecond;
+    }
+    ConsoleReporter::ReportRuns(runs);
+}
+
+// The benchmark entries are flat objects of strings and numbers, which is
+// all this reader understands
+static bool readString(const std::string& text, size_t& pos, std::string& out) {
+    out.clear();
+    for (++pos; pos < text.size() && text[pos] != '"'; ++pos) {
+        if (text[pos] == '\\' && pos + 1 < text.size()) ++pos;
+        out += text[pos];
+    }
+    ++pos;
+    return pos <= text.size();
+}
+
+bool loadBaseline(const std::string& path, std::map<std::string, double>& cpuNs, std::string& error) {
+    std::ifstream in(path.c_str());
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    const std::string text = buffer.str();
+
+    size_t pos = text.find("\"benchmarks\"");
+    if (pos == std::string::npos || (pos = text.find('[', pos)) == std::string::npos) {
+        error = path + " has no benchmarks array";
+        return false;
+    }
+    while ((pos = text.find_first_of("{]", pos)) != std::string::npos && text[pos] == '{') {
+        std::map<std::string, std::string> fields;
+        ++pos;
+        while (pos < text.size() && text[pos] != '}') {
+            if (text[pos] != '"') {
+                ++pos;
+                continue;
+            }
+            std::string key, value;
+            readString(text, pos, key);
+            pos = text.find(':', pos) + 1;
+            while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\n')) ++pos;
+            if (pos < text.size() && text[pos] == '"') {
+                readString(text, pos, value);
+            } else {
+                size_t end = text.find_first_of(",}\n", pos);
+                value = text.substr(pos, end - pos);
+                pos = end;
+            }
+            fields[key] = value;
+        }
+        if (fields.count("name") && fields.count("cpu_time") &&
+            compared(fields["run_type"] == "aggregate", fields["aggregate_name"])) {
+            cpuNs[fields["name"]] = toNanoseconds(std::atof(fields["cpu_time"].c_str()), fields["time_unit"]);
+        }
+        ++pos;
+    }
+    if (cpuNs.empty()) {
+        error = path + " has no usable runs";
+        return false;
+    }
+    return true;
+}
+
+bool checkBaseline(const std::map<std::string, double>& baseline, const std::map<std::string, double>& current,
+                   double maxRegression) {
+    int matched = 0, regressions = 0;
+    std::printf("\n%-36s %14s %14s %9s\n", "benchmark", "baseline ns", "current ns", "change");
+    for (std::map<std::string, double>::const_iterator it = current.begin(); it != current.end(); ++it) {
+        std::map<std::string, double>::const_iterator base = baseline.find(it->first);
+        if (base == baseline.end() || base->second <= 0.0) continue;
+        double change = it->second / base->second - 1.0;
+        bool regressed = change > maxRegression;
+        std::printf("%-36s %14.1f %14.1f %+8.1f%%%s\n", it->first.c_str(), base->second, it->second,
+                    change * 100.0, regressed ? "  REGRESSION" : "");
+        ++matched;
+        if (regressed) ++regressions;
+    }
+    if (matched == 0) {
+        std::printf("no benchmark matched the baseline\n");
+        return false;
+    }
+    std::printf("%d of %d benchmarks more than %.0f%% slower than the baseline\n", regressions, matched,
+                maxRegression * 100.0);
+    return regressions == 0;
+}
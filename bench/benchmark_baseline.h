@@ -0,0 +1,34 @@
+//
+//  benchmark_baseline.h
+//  Fish-Fillet-Project
+//
+//  Regression check for sim_benchmark: remembers the CPU time of every run
+//  while printing the usual console table, then compares against a JSON
+//  file written earlier with --benchmark_out. Only plain runs and median
+//  aggregates are compared, since means and deviations are too noisy.
+//
+
+#ifndef BENCHMARK_BASELINE_H
+#define BENCHMARK_BASELINE_H
+
+#include <benchmark/benchmark.h>
+#include <map>
+#include <string>
+#include <vector>
+
+class RecordingReporter : public benchmark::ConsoleReporter {
+public:
+    std::map<std::string, double> cpuNs;  // By benchmark name, as in the JSON
+
+    void ReportRuns(const std::vector<Run>& runs) override;
+};
+
+// CPU times by name from a Google Benchmark JSON file
+bool loadBaseline(const std::string& path, std::map<std::string, double>& cpuNs, std::string& error);
+
+// Print current against baseline for every name in both; false if any run
+// is more than maxRegression (0.10 = 10%) slower, or nothing matched
+bool checkBaseline(const std::map<std::string, double>& baseline, const std::map<std::string, double>& current,
+                   double maxRegression);
+
+#endif // BENCHMARK_BASELINE_H
@@ -0,0 +1,81 @@
+//
+//  flock_bench.cpp
+//  Fish-Fillet-Project
+//
+//  Whole-tick cost of the default level as the ocean grows: with no
+//  fish-to-fish behavior, with schooling only, and with schooling and
+//  hunting. Hunters thin out crowded oceans quickly, so "left" is how many
+//  fish the last run ended with. The player is parked above the water so
+//  rounds never end early; exits with 1 if one does anyway, since its ticks
+//  would time nothing. A tick has to stay under 16.7 ms to keep up with a
+//  60 Hz display on one core.
+//
+//  cmake --build build --target flock_bench
+//  ./flock_bench [threads]
+//
+
+#include "job_system.h"
+#include "world.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+typedef std::chrono::steady_clock Clock;
+
+const uint64_t BENCH_SEED = 7;
+
+static std::shared_ptr<const Level> oceanLevel(int fish, bool schooling, bool hunting) {
+    std::string text = "fish " + std::to_string(fish) + "\ntime 100000\n";
+    if (!hunting) text += "hunt_speed 0\n";
+    if (!schooling) {
+        for (const char* name : {"small", "medium", "large"}) text += std::string("school ") + name + " 0 0 0\n";
+    }
+    std::shared_ptr<Level> level(new Level());
+    std::string error;
+    if (!level->parseText(text, error)) {
+        std::fprintf(stderr, "level: %s\n", error.c_str());
+        std::exit(1);
+    }
+    return level;
+}
+
+// Park the player before the reset, which starts the collision sweep from
+// where the player is; parking after it would sweep across the fish
+static double msPerTick(World& world, JobSystem* jobs, const std::shared_ptr<const Level>& level, int ticks) {
+    world.jobs = jobs;
+    world.setLevel(level);
+    world.player.y = WINDOW_HEIGHT + 1000.0f;
+    world.reset(BENCH_SEED);
+    Clock::time_point start = Clock::now();
+    for (int t = 0; t < ticks; ++t) world.tick();
+    std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+    if (world.isGameOver) {
+        std::fprintf(stderr, "round ended at tick %ld; the timings would be of idle ticks\n", world.tickCount);
+        std::exit(1);
+    }
+    return elapsed.count() / ticks;
+}
+
+// Optional argument: total threads (default 1, the single-core case)
+int main(int argc, char* argv[]) {
+    const int counts[] = {20, 1000, 10000, 20000};
+    int threads = argc > 1 ? std::atoi(argv[1]) : 1;
+    JobSystem jobs(threads > 1 ? threads - 1 : 0);
+
+    std::printf("threads: %u\n", threads > 1 ? jobs.threadCount() : 1u);
+    std::printf("%8s %10s %10s %10s %8s %12s\n", "fish", "plain ms", "school ms", "hunt ms", "left",
+                "school 60Hz");
+    JobSystem* pool = threads > 1 ? &jobs : 0;
+    for (int n : counts) {
+        int ticks = n >= 10000 ? 200 : 1000;
+        World plain(7), school(7), hunt(7);
+        double plainMs = msPerTick(plain, pool, oceanLevel(n, false, false), ticks);
+        double schoolMs = msPerTick(school, pool, oceanLevel(n, true, false), ticks);
+        double huntMs = msPerTick(hunt, pool, oceanLevel(n, true, true), ticks);
+        std::printf("%8d %10.3f %10.3f %10.3f %8zu %12s\n", n, plainMs, schoolMs, huntMs, hunt.fish.size(),
+                    schoolMs < 1000.0 / 60.0 ? "yes" : "no");
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+//
+//  level_bench.cpp
+//  Fish-Fillet-Project
+//
+//  Levels (level.h): time to parse each level in levels/ from text and to
+//  load it compiled, then checks the parser on lines it must reject. Counts
+//  that land in narrow fields (fish, spawn odds, points) have to fail with
+//  their line number rather than wrap into something huge or negative.
+//
+//  Exits with 1 if a check fails.
+//
+//  cmake --build build --target level_bench
+//  ./level_bench            (from the repository root, to find levels/)
+//
+
+#include "level.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+typedef std::chrono::steady_clock Clock;
+
+static bool readFile(const char* path, std::string& text) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    std::ostringstream out;
+    out << in.rdbuf();
+    text = out.str();
+    return true;
+}
+
+// Parse and compiled-load timings for one level file
+static bool timeLevel(const char* path) {
+    std::string text, error;
+    if (!readFile(path, text)) {
+        std::printf("%-24s not found (run from the repository root)\n", path);
+        return false;
+    }
+    const int passes = 200;
+    Clock::time_point t0 = Clock::now();
+    for (int p = 0; p < passes; ++p) {
+        Level level;
+        if (!level.parseText(text, error)) {
+            std::printf("%-24s %s\n", path, error.c_str());
+            return false;
+        }
+    }
+    Clock::time_point t1 = Clock::now();
+
+    Level parsed;
+    parsed.parseText(text, error);
+    const char* compiled = "level_bench.lvlb";
+    if (!parsed.writeBinary(compiled, error)) {
+        std::printf("%-24s %s\n", path, error.c_str());
+        return false;
+    }
+    Clock::time_point t2 = Clock::now();
+    for (int p = 0; p < passes; ++p) {
+        Level level;
+        level.load(compiled, error);
+    }
+    Clock::time_point t3 = Clock::now();
+    std::remove(compiled);
+
+    std::chrono::duration<double, std::micro> parse = t1 - t0, load = t3 - t2;
+    std::printf("%-24s %12.1f %12.1f\n", path, parse.count() / passes, load.count() / passes);
+    return true;
+}
+
+struct ParseCase {
+    const char* text;
+    const char* error;  // Expected error, or 0 if the text must parse
+};
+
+static const ParseCase CASES[] = {
+    {"fish 20\nred 3 7\nred_points 3\n", 0},
+    {"red 0 65535\n", 0},
+    {"fish -1\n", "1: fish must be between 0 and 1000000"},
+    {"fish 4000000000\n", "1: fish must be between 0 and 1000000"},
+    {"time 20\nred -1 7\n", "2: 'red' counts must be between 0 and 65535"},
+    {"red 3 65536\n", "1: 'red' counts must be between 0 and 65535"},
+    {"red_points -1\n", "1: 'red_points' counts must be between 0 and 65535"},
+    {"red_points 70000\n", "1: 'red_points' counts must be between 0 and 65535"},
+    {"species small 0.8 -4 1 0 1 1 1\n", "1: 'species' counts must be between 0 and 65535"},
+    {"species small 0.8 4 99999 0 1 1 1\n", "1: 'species' counts must be between 0 and 65535"},
+    {"red x 7\n", "1: bad value for 'red'"},
+};
+
+static bool parseChecks() {
+    bool ok = true;
+    for (const ParseCase& c : CASES) {
+        Level level;
+        std::string error;
+        bool parsed = level.parseText(c.text, error);
+        bool pass = c.error ? !parsed && error == c.error : parsed;
+        if (!pass) {
+            std::printf("parse \"%s\": expected %s, got %s\n", c.text, c.error ? c.error : "success",
+                        parsed ? "success" : error.c_str());
+        }
+        ok = ok && pass;
+    }
+    std::printf("parse checks: %s\n", ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main() {
+    const char* paths[] = {"levels/default.level", "levels/reef.level", "levels/big_ocean.level"};
+    std::printf("%-24s %12s %12s\n", "level", "parse us", "load us");
+    bool ok = true;
+    for (const char* path : paths) ok = timeLevel(path) && ok;
+    ok = parseChecks() && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+//
+//  particle_bench.cpp
+//  Fish-Fillet-Project
+//
+//  Particles (particles.h): time to update the pool and to build its points
+//  at 10k, 50k and the pool's full 65k live particles, against the 16.7 ms
+//  of a 60 Hz frame. Then checks the promises the game relies on:
+//
+//  - no allocation: a minute of frames with bursts and plankton allocates
+//    nothing once the pool is built.
+//  - bounded: emitting far more than the capacity overwrites the oldest
+//    particles and never grows the pool.
+//  - plankton: the view settles at the count the ambient rate implies.
+//
+//  Exits with 1 if a check fails.
+//
+//  cmake --build build --target particle_bench
+//  ./particle_bench
+//
+
+#include "alloc_stats.h"
+#include "game_config.h"
+#include "particles.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+typedef std::chrono::steady_clock Clock;
+
+const float FRAME_DT = 1.0f / 60.0f;
+
+// count bubbles spread over the view
+static void fill(ParticleSystem& particles, int count) {
+    particles.clear();
+    for (int n = 0; n < count; ++n) {
+        particles.emitBubbles(20.0f + (n * 37) % (WINDOW_WIDTH - 40), 20.0f + (n * 53) % (OCEAN_HEIGHT - 40), 1);
+    }
+}
+
+static bool noAllocations() {
+    static const unsigned char gold[3] = {255, 215, 40};
+    ParticleSystem particles;
+    AllocationStats before = threadAllocations();
+    for (int frame = 0; frame < 3600; ++frame) {
+        if (frame % 20 == 0) particles.emitScales(600.0f, 300.0f, 80, gold, 260.0f);
+        if (frame % 7 == 0) particles.emitBubbles(300.0f, 200.0f, 30);
+        particles.emitPlankton(0.0f, 0.0f, WINDOW_WIDTH, OCEAN_HEIGHT, FRAME_DT);
+        particles.update(FRAME_DT);
+        particles.buildPoints(0.0f, 0.0f, WINDOW_WIDTH, OCEAN_HEIGHT);
+    }
+    uint64_t allocs = allocationsSince(before, threadAllocations());
+    std::printf("allocations over 3600 frames: %llu\n", static_cast<unsigned long long>(allocs));
+    return allocs == 0;
+}
+
+static bool bounded() {
+    ParticleSystem particles(4096);
+    for (int n = 0; n < 50; ++n) particles.emitBubbles(100.0f, 100.0f, 1000);
+    particles.update(FRAME_DT);
+    bool ok = particles.capacity() == 4096 && particles.live() == 4096;
+    std::printf("50000 bubbles into a pool of %zu: %zu live %s\n", particles.capacity(), particles.live(),
+                ok ? "ok" : "WRONG");
+    return ok;
+}
+
+static bool plankton() {
+    ParticleSystem particles;
+    for (int frame = 0; frame < 60 * 30; ++frame) {
+        particles.emitPlankton(0.0f, 0.0f, WINDOW_WIDTH, OCEAN_HEIGHT, FRAME_DT);
+        particles.update(FRAME_DT);
+    }
+    // Lifetimes average 3/4 of the plankton's, so the view holds about that
+    // share of the ambient count once it settles
+    double expected = AMBIENT_PLANKTON * 0.75;
+    bool ok = std::fabs(particles.live() - expected) < expected * 0.15;
+    std::printf("plankton after 30 s: %zu live (about %.0f expected) %s\n", particles.live(), expected,
+                ok ? "ok" : "WRONG");
+    return ok;
+}
+
+int main() {
+    const int counts[] = {10000, 50000, 65536};
+    ParticleSystem particles;
+
+    std::printf("%8s %12s %12s %12s\n", "live", "update us", "points us", "frame %");
+    for (int n : counts) {
+        fill(particles, n);
+        particles.update(0.0f);
+        const int passes = 300;
+        double updateUs = 0.0, pointsUs = 0.0;
+        for (int p = 0; p < passes; ++p) {
+            Clock::time_point t0 = Clock::now();
+            particles.update(FRAME_DT / 1000.0f);  // Barely moves, so all stay alive and in view
+            Clock::time_point t1 = Clock::now();
+            particles.buildPoints(0.0f, 0.0f, WINDOW_WIDTH, OCEAN_HEIGHT);
+            Clock::time_point t2 = Clock::now();
+            updateUs += std::chrono::duration<double, std::micro>(t1 - t0).count();
+            pointsUs += std::chrono::duration<double, std::micro>(t2 - t1).count();
+        }
+        updateUs /= passes;
+        pointsUs /= passes;
+        std::printf("%8zu %12.1f %12.1f %12.1f\n", particles.live(), updateUs, pointsUs,
+                    100.0 * (updateUs + pointsUs) / (1e6 * FRAME_DT));
+    }
+
+    bool ok = noAllocations();
+    ok = bounded() && ok;
+    ok = plankton() && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+//
+//  sim_benchmark.cpp
+//  Fish-Fillet-Project
+//
+//  Google Benchmark suite for the simulation at 20, 1k, 10k and 100k fish:
+//  the behavior kernel alone, flocking plus behavior (World::moveFish),
+//  collisions and eating (World::resolveCollisions), spawning a round,
+//  whole ticks, and the CPU side of drawing (FishMesh::build). The player
+//  is parked above the water so rounds never end early, and every world is
+//  reset to the same seed every RESET_TICKS ticks (untimed), so each run
+//  measures the same fish doing the same things.
+//
+//  Built by CMake as sim_benchmark. With --baseline=FILE the results are
+//  compared against an earlier --benchmark_out JSON file and the program
+//  exits with 1 if anything got more than 10% slower (--max-regression to
+//  change). Unless told otherwise it runs every benchmark 5 times,
+//  interleaved, and reports the aggregates only; the medians are what
+//  gets compared.
+//
+//  cmake --build build --target bench_check      # compare with bench/baseline.json
+//  cmake --build build --target bench_baseline   # rewrite it on this machine
+//
+
+#include "alloc_stats.h"
+#include "behavior_kernel.h"
+#include "benchmark_baseline.h"
+#include "fish_mesh.h"
+#include "world.h"
+#include "world_snapshot.h"
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+const uint64_t BENCH_SEED = 7;
+const int RESET_TICKS = 10;
+
+static std::shared_ptr<const Level> oceanLevel(int fish) {
+    std::shared_ptr<Level> level(new Level());
+    std::string error;
+    if (!level->parseText("fish " + std::to_string(fish) + "\ntime 1000000\n", error)) {
+        std::fprintf(stderr, "level: %s\n", error.c_str());
+        std::exit(1);
+    }
+    return level;
+}
+
+static void setUpWorld(World& world, int fish) {
+    world.setLevel(oceanLevel(fish));
+    world.player.y = WINDOW_HEIGHT + 1000.0f;
+    world.reset(BENCH_SEED);
+}
+
+// Untimed reset every RESET_TICKS iterations
+static void resetNow(benchmark::State& state, World& world, int& ticks) {
+    if (++ticks < RESET_TICKS) return;
+    state.PauseTiming();
+    world.reset(BENCH_SEED);
+    ticks = 0;
+    state.ResumeTiming();
+}
+
+static void BM_Behavior(benchmark::State& state) {
+    World world;
+    setUpWorld(world, static_cast<int>(state.range(0)));
+    BehaviorParams params = behaviorParams(world.level->rules);
+    int ticks = 0;
+    for (auto _ : state) {
+        updateFishBehavior(world.fish, world.player.x, world.player.y, world.playerRadius(), params, 0, 0,
+                           world.rng);
+        resetNow(state, world, ticks);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_MoveFish(benchmark::State& state) {
+    World world;
+    setUpWorld(world, static_cast<int>(state.range(0)));
+    int ticks = 0;
+    for (auto _ : state) {
+        world.moveFish();
+        resetNow(state, world, ticks);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Collision(benchmark::State& state) {
+    World world;
+    setUpWorld(world, static_cast<int>(state.range(0)));
+    int ticks = 0;
+    for (auto _ : state) {
+        world.resolveCollisions();
+        resetNow(state, world, ticks);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// A whole round's worth of randomizeFishPositionAway plus store setup
+static void BM_Spawn(benchmark::State& state) {
+    World world;
+    setUpWorld(world, static_cast<int>(state.range(0)));
+    for (auto _ : state) {
+        world.reset(BENCH_SEED);
+        benchmark::DoNotOptimize(world.fish.size());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Also reports heap allocations per tick, which should be 0
+static void BM_WorldTick(benchmark::State& state) {
+    World world;
+    setUpWorld(world, static_cast<int>(state.range(0)));
+    int ticks = 0;
+    uint64_t allocations = 0;
+    for (auto _ : state) {
+        AllocationStats before = threadAllocations();
+        world.tick();
+        allocations += allocationsSince(before, threadAllocations());
+        resetNow(state, world, ticks);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+}
+
+static void BM_FishMesh(benchmark::State& state) {
+    World world;
+    setUpWorld(world, static_cast<int>(state.range(0)));
+    WorldSnapshot view;
+    view.capture(world);
+    FishMesh mesh;
+    for (auto _ : state) {
+        mesh.build(view);
+        benchmark::DoNotOptimize(mesh.vertexCount());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void fishCounts(benchmark::internal::Benchmark* b) {
+    b->Arg(20)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+}
+
+static void smallOceans(benchmark::internal::Benchmark* b) {
+    b->Arg(20)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+}
+
+// A 100k tick is slow enough that the automatic iteration count would stop
+// partway through the first reset cycle, timing different ticks each run
+static void largeOcean(benchmark::internal::Benchmark* b) {
+    b->Arg(100000)->Iterations(RESET_TICKS)->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK(BM_Behavior)->Apply(fishCounts);
+BENCHMARK(BM_MoveFish)->Apply(smallOceans);
+BENCHMARK(BM_MoveFish)->Apply(largeOcean);
+BENCHMARK(BM_Collision)->Apply(smallOceans);
+BENCHMARK(BM_Collision)->Apply(largeOcean);
+BENCHMARK(BM_Spawn)->Apply(fishCounts);
+BENCHMARK(BM_WorldTick)->Apply(smallOceans);
+BENCHMARK(BM_WorldTick)->Apply(largeOcean);
+BENCHMARK(BM_FishMesh)->Apply(fishCounts);
+
+int main(int argc, char* argv[]) {
+    std::string baselinePath;
+    double maxRegression = 0.10;
+    bool repetitionsGiven = false;
+
+    // Take our own flags out before Google Benchmark sees the rest
+    std::vector<char*> args;
+    for (int i = 0; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--baseline=", 11) == 0) {
+            baselinePath = argv[i] + 11;
+        } else if (std::strncmp(argv[i], "--max-regression=", 17) == 0) {
+            maxRegression = std::atof(argv[i] + 17);
+        } else {
+            if (std::strncmp(argv[i], "--benchmark_repetitions", 23) == 0) repetitionsGiven = true;
+            args.push_back(argv[i]);
+        }
+    }
+    // Interleaving the repetitions spreads a slow spell on a shared machine
+    // over every benchmark instead of letting it land on one
+    char repetitions[] = "--benchmark_repetitions=5";
+    char aggregatesOnly[] = "--benchmark_report_aggregates_only=true";
+    char interleave[] = "--benchmark_enable_random_interleaving=true";
+    if (!repetitionsGiven) {
+        args.push_back(repetitions);
+        args.push_back(aggregatesOnly);
+        args.push_back(interleave);
+    }
+    int count = static_cast<int>(args.size());
+    args.push_back(0);
+
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) return 1;
+
+    RecordingReporter reporter;
+    benchmark::RunSpecifiedBenchmarks(&reporter);
+    benchmark::Shutdown();
+
+    if (baselinePath.empty()) return 0;
+    std::map<std::string, double> baseline;
+    std::string error;
+    if (!loadBaseline(baselinePath, baseline, error)) {
+        std::fprintf(stderr, "baseline: %s\n", error.c_str());
+        return 1;
+    }
+    return checkBaseline(baseline, reporter.cpuNs, maxRegression) ? 0 : 1;
+}
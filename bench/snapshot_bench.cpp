@@ -0,0 +1,164 @@
+//
+//  snapshot_bench.cpp
+//  Fish-Fillet-Project
+//
+//  Render snapshots (world_snapshot.h): time to capture a world and to
+//  blend two snapshots for 1k, 10k and 100k fish. Then checks the matching
+//  blend() relies on, on a scrolling ocean whose camera keeps moving:
+//
+//  - scrolling: every tick fish fall asleep in chunks leaving the view and
+//    others wake into the slots they freed. A fish in a reused slot is a
+//    different fish and must be drawn where it is, never blended from the
+//    one that had the slot before; a fish present in both snapshots is
+//    blended unless it jumped further than MAX_BLEND_DISTANCE.
+//  - adjacent: scrolling puts the chunks leaving and entering the view
+//    far apart, but a camera jump can send one chunk to sleep and wake its
+//    neighbour in one update. A fish waking a few pixels from the one whose
+//    slot it takes must still not be blended from it.
+//
+//  Exits with 1 if a check fails.
+//
+//  cmake --build build --target snapshot_bench
+//  ./snapshot_bench
+//
+
+#include "world.h"
+#include "world_snapshot.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+const float ALPHA = 0.5f;
+const long CHECK_TICKS = 1500;
+
+static std::shared_ptr<const Level> levelWith(uint32_t fishCount, float worldWidth, float worldHeight,
+                                              bool hunting = true) {
+    LevelRules rules = defaultLevel()->rules;
+    if (!hunting) rules.huntSpeedMult = 0.0f;  // Crowded fish would eat each other at once
+    rules.fishCount = fishCount;
+    rules.initialPlayerSize = rules.maxPlayerSize = 2.0f;  // Outlasts the check
+    rules.initialTime = 1000;
+    rules.worldWidth = worldWidth;
+    rules.worldHeight = worldHeight;
+    std::string error;
+    return defaultLevel()->withRules(rules, error);
+}
+
+// Mouse sweeping along the right edge, then the left, so the camera keeps
+// crossing chunk borders both ways
+static void steer(World& world, long tick) {
+    float x = (tick / 400) % 2 == 0 ? WINDOW_WIDTH - 10.0f : 10.0f;
+    world.mouseMove(x, 100.0f + (tick % 300));
+}
+
+static bool checkReusedSlots() {
+    World world(11);
+    world.setLevel(levelWith(8000, 12000.0f, 5000.0f));
+    world.reset();
+    WorldSnapshot from, to, blended;
+    std::vector<int> scratch;
+    std::vector<int> fromIndex;
+    long reused = 0, reusedNear = 0, matched = 0, wrong = 0;
+
+    to.capture(world);
+    for (long t = 0; t < CHECK_TICKS && !world.isGameOver; ++t) {
+        from = to;
+        steer(world, t);
+        world.tick();
+        to.capture(world);
+        blended.blend(from, to, ALPHA, scratch);
+
+        fromIndex.assign(world.fish.capacity() + 1, -1);
+        for (size_t j = 0; j < from.fishCount(); ++j) {
+            if (from.id[j] < fromIndex.size()) fromIndex[from.id[j]] = static_cast<int>(j);
+        }
+        for (size_t i = 0; i < to.fishCount(); ++i) {
+            int j = to.id[i] < fromIndex.size() ? fromIndex[to.id[i]] : -1;
+            if (j < 0) continue;
+            float expectX = to.x[i], expectY = to.y[i];
+            bool near = std::fabs(from.x[j] - to.x[i]) <= MAX_BLEND_DISTANCE &&
+                        std::fabs(from.y[j] - to.y[i]) <= MAX_BLEND_DISTANCE;
+            if (from.generation[j] != to.generation[i]) {
+                ++reused;
+                if (near) ++reusedNear;
+            } else if (near) {
+                ++matched;
+                expectX = from.x[j] + (to.x[i] - from.x[j]) * ALPHA;
+                expectY = from.y[j] + (to.y[i] - from.y[j]) * ALPHA;
+            }
+            if (blended.x[i] != expectX || blended.y[i] != expectY) ++wrong;
+        }
+    }
+    bool ok = wrong == 0 && reused > 0 && matched > 0;
+    std::printf("scrolling %ld ticks: %ld fish in reused slots (%ld within blend distance), %ld blended, "
+                "%ld wrong: %s\n", CHECK_TICKS, reused, reusedNear, matched, wrong, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+// One fish awake at the right edge of chunk 4 and one asleep just across
+// the border in chunk 5. Moving the view from x 0 to x 2400 in one update
+// sends chunk 4 to sleep and wakes chunk 5, whose fish takes the freed slot.
+static bool checkAdjacentChunks() {
+    World world(3);
+    world.setLevel(levelWith(2, 4000.0f, 2000.0f));
+    world.reset();
+    long tick = world.tickCount;
+    world.fish.clear();
+    world.chunks.reset(4000.0f, 2000.0f, 2);
+    world.chunks.putToSleep(5, Fish(2005.0f, 200.0f, 0.0f, 1.0f, false, 0), tick);
+    world.fish.push(Fish(1995.0f, 200.0f, 0.0f, 1.0f, false, 0));
+    world.chunks.update(world.fish, 0.0f, 0.0f, WINDOW_WIDTH, OCEAN_HEIGHT, tick);
+
+    WorldSnapshot from, to, blended;
+    std::vector<int> scratch;
+    from.capture(world);
+    world.tickCount = ++tick;
+    world.chunks.update(world.fish, 2400.0f, 0.0f, WINDOW_WIDTH, OCEAN_HEIGHT, tick);
+    to.capture(world);
+    blended.blend(from, to, ALPHA, scratch);
+
+    bool reused = from.fishCount() == 1 && to.fishCount() == 1 && from.id[0] == to.id[0] &&
+                  from.x[0] == 1995.0f && to.x[0] == 2005.0f;
+    bool ok = reused && blended.x[0] == to.x[0];
+    std::printf("adjacent chunks: %s, fish drawn at x %.1f (woke at %.1f, slot's old fish at %.1f): %s\n",
+                reused ? "slot reused" : "SLOT NOT REUSED", blended.fishCount() ? blended.x[0] : 0.0f,
+                to.fishCount() ? to.x[0] : 0.0f, from.fishCount() ? from.x[0] : 0.0f, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main() {
+    const uint32_t counts[] = {1000, 10000, 100000};
+
+    std::printf("%8s %12s %12s\n", "fish", "capture us", "blend us");
+    for (uint32_t n : counts) {
+        World world(1);
+        world.setLevel(levelWith(n, WINDOW_WIDTH, OCEAN_HEIGHT, false));
+        world.player.y = WINDOW_HEIGHT + 1000.0f;  // Parked above the water, eating nothing
+        world.reset();
+        WorldSnapshot from, to, blended;
+        std::vector<int> scratch;
+        from.capture(world);
+        world.tick();
+        to.capture(world);
+        blended.blend(from, to, ALPHA, scratch);  // Once untimed, to size the storage
+        int passes = n >= 100000 ? 100 : 1000;
+
+        Clock::time_point t0 = Clock::now();
+        for (int p = 0; p < passes; ++p) to.capture(world);
+        Clock::time_point t1 = Clock::now();
+        for (int p = 0; p < passes; ++p) blended.blend(from, to, ALPHA, scratch);
+        Clock::time_point t2 = Clock::now();
+
+        std::chrono::duration<double, std::micro> capture = t1 - t0, blend = t2 - t1;
+        std::printf("%8zu %12.1f %12.1f\n", to.fishCount(), capture.count() / passes, blend.count() / passes);
+    }
+
+    bool ok = checkReusedSlots();
+    ok = checkAdjacentChunks() && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,93 @@
+//
+//  spatial_hash_bench.cpp
+//  Fish-Fillet-Project
+//
+//  Per-step cost of the spatial hash against a brute-force scan as the
+//  fish count grows. "player" is the collision query the game runs every
+//  tick; "all-pairs" is every fish asking for neighbors inside its own
+//  contact distance, the query fish-vs-fish behaviors will need.
+//
+//  g++ -O2 -I. bench/spatial_hash_bench.cpp spatial_hash.cpp -o spatial_hash_bench
+//
+
+#include "game_config.h"
+#include "spatial_hash.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static double microsSince(Clock::time_point start, int reps) {
+    std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return elapsed.count() / reps;
+}
+
+int main() {
+    const int counts[] = {20, 100, 1000, 10000, 100000};
+    const float playerQuery = COLLISION_RADIUS * MAX_PLAYER_SIZE + COLLISION_RADIUS * SIZE_MULTIPLIERS[LARGE];
+    const float pairQuery = 2.0f * COLLISION_RADIUS * SIZE_MULTIPLIERS[LARGE];
+    const float pairQuery2 = pairQuery * pairQuery;
+
+    std::printf("%8s %12s %12s %14s %14s %14s\n",
+                "fish", "build us", "player us", "all-pairs us", "brute us", "neighbors");
+
+    for (int n : counts) {
+        std::srand(1234);
+        std::vector<float> xs(n), ys(n);
+        for (int i = 0; i < n; ++i) {
+            xs[i] = static_cast<float>(std::rand() % WINDOW_WIDTH);
+            ys[i] = static_cast<float>(40 + std::rand() % (OCEAN_HEIGHT - 70));
+        }
+
+        SpatialHash grid(WINDOW_WIDTH, OCEAN_HEIGHT);
+        std::vector<int> hits;
+        int reps = n >= 10000 ? 20 : 2000;
+
+        Clock::time_point t0 = Clock::now();
+        for (int r = 0; r < reps; ++r) grid.build(xs.data(), ys.data(), n);
+        double buildUs = microsSince(t0, reps);
+
+        t0 = Clock::now();
+        for (int r = 0; r < reps; ++r) grid.queryRadius(600.0f, 250.0f, playerQuery, hits);
+        double playerUs = microsSince(t0, reps);
+
+        long hashPairs = 0;
+        int pairReps = n >= 10000 ? 2 : 50;
+        t0 = Clock::now();
+        for (int r = 0; r < pairReps; ++r) {
+            hashPairs = 0;
+            for (int i = 0; i < n; ++i) {
+                grid.forEachInRadius(xs[i], ys[i], pairQuery, [&hashPairs](int) { ++hashPairs; });
+            }
+        }
+        double pairUs = microsSince(t0, pairReps);
+
+        // Brute force gets slow quickly; skip it where it would take minutes
+        double bruteUs = -1.0;
+        if (n <= 10000) {
+            long brutePairs = 0;
+            t0 = Clock::now();
+            for (int r = 0; r < pairReps; ++r) {
+                brutePairs = 0;
+                for (int i = 0; i < n; ++i) {
+                    for (int j = 0; j < n; ++j) {
+                        float dx = xs[j] - xs[i];
+                        float dy = ys[j] - ys[i];
+                        if (dx * dx + dy * dy <= pairQuery2) ++brutePairs;
+                    }
+                }
+            }
+            bruteUs = microsSince(t0, pairReps);
+            if (brutePairs != hashPairs) {
+                std::printf("mismatch at %d fish: hash %ld brute %ld\n", n, hashPairs, brutePairs);
+                return 1;
+            }
+        }
+
+        std::printf("%8d %12.2f %12.3f %14.1f %14.1f %14ld\n",
+                    n, buildUs, playerUs, pairUs, bruteUs, hashPairs);
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+//
+//  steering_bench.cpp
+//  Fish-Fillet-Project
+//
+//  The behavior kernel (behavior_kernel.h) against the plain loop in a
+//  crowded ocean where every fish is inside flee range, so every lane
+//  steers. Prints the time per pass for both, then checks the promise the
+//  kernel makes: TRAJECTORY_TICKS ticks of fleeing and chasing a player
+//  sweeping through the crowd leave every fish at bit-identical positions
+//  and directions on both paths. Any gap at all is a failure; there is no
+//  drift to bound.
+//
+//  Exits with 1 if a fish differs.
+//
+//  cmake --build build --target steering_bench
+//  ./steering_bench
+//
+
+#include "behavior_kernel.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+const float CROWD_SIZE = 300.0f;        // Side of the square the fish start in
+const float PLAYER_X = 600.0f;
+const float PLAYER_Y = 250.0f;
+const float BIG_PLAYER = 40.0f;         // Every fish flees
+const float SMALL_PLAYER = 5.0f;        // Red and chasing fish chase
+const int TRAJECTORY_TICKS = 500;
+
+// n fish spread over a CROWD_SIZE square around the player
+static void fillCrowd(FishStore& fish, int n) {
+    Rng rng(1234);
+    fish.clear();
+    fish.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        Fish f(rng, defaultLevel()->rules);
+        f.x = PLAYER_X - CROWD_SIZE * 0.5f + rng.nextInt(static_cast<int>(CROWD_SIZE) * 16) / 16.0f;
+        f.y = PLAYER_Y - CROWD_SIZE * 0.5f + rng.nextInt(static_cast<int>(CROWD_SIZE) * 16) / 16.0f;
+        fish.push(f);
+    }
+}
+
+typedef void (*SteerFn)(FishStore&, size_t, size_t, float, float, float, const BehaviorParams&,
+                        const float*, const float*);
+
+// Microseconds per steering pass, fish put back between passes (untimed)
+static double timeSteering(SteerFn steer, FishStore& fish, const BehaviorParams& params, int passes) {
+    std::vector<float> x(fish.x.begin(), fish.x.end()), y(fish.y.begin(), fish.y.end());
+    std::vector<float> dir(fish.direction.begin(), fish.direction.end());
+    std::chrono::duration<double, std::micro> total(0.0);
+    for (int p = 0; p < passes; ++p) {
+        Clock::time_point t0 = Clock::now();
+        steer(fish, 0, fish.size(), PLAYER_X, PLAYER_Y, BIG_PLAYER, params, 0, 0);
+        total += Clock::now() - t0;
+        std::copy(x.begin(), x.end(), fish.x.begin());
+        std::copy(y.begin(), y.end(), fish.y.begin());
+        std::copy(dir.begin(), dir.end(), fish.direction.begin());
+    }
+    return total.count() / passes;
+}
+
+// Fish whose position or direction differs between the paths after
+// TRAJECTORY_TICKS ticks, the player crossing the crowd and switching
+// between big and small every 50 ticks
+static size_t trajectoryMismatches(const FishStore& start, const BehaviorParams& params) {
+    FishStore scalar = start, simd = start;
+    for (int t = 0; t < TRAJECTORY_TICKS; ++t) {
+        float px = PLAYER_X - CROWD_SIZE + (t % 200) * (CROWD_SIZE / 100.0f);
+        float radius = (t / 50) % 2 ? SMALL_PLAYER : BIG_PLAYER;
+        steerFishScalar(scalar, 0, scalar.size(), px, PLAYER_Y, radius, params);
+        steerFishSimd(simd, 0, simd.size(), px, PLAYER_Y, radius, params);
+    }
+    size_t mismatches = 0;
+    for (size_t i = 0; i < start.size(); ++i) {
+        if (simd.x[i] != scalar.x[i] || simd.y[i] != scalar.y[i] || simd.direction[i] != scalar.direction[i]) {
+            ++mismatches;
+        }
+    }
+    return mismatches;
+}
+
+int main() {
+    const int counts[] = {1000, 10000, 100000};
+    BehaviorParams params = behaviorParams(defaultLevel()->rules);
+    bool ok = true;
+
+    std::printf("kernel: %s\n", behaviorKernelName());
+    std::printf("%8s %10s %10s %8s %11s\n", "fish", "scalar us", "simd us", "speedup", "mismatches");
+    for (int n : counts) {
+        FishStore fish;
+        fillCrowd(fish, n);
+        int passes = n >= 100000 ? 50 : 500;
+
+        // Warm both paths once so neither pays for cold caches
+        timeSteering(steerFishScalar, fish, params, 1);
+        timeSteering(steerFishSimd, fish, params, 1);
+        double scalarUs = timeSteering(steerFishScalar, fish, params, passes);
+        double simdUs = timeSteering(steerFishSimd, fish, params, passes);
+
+        size_t mismatches = trajectoryMismatches(fish, params);
+        ok = ok && mismatches == 0;
+        std::printf("%8d %10.1f %10.1f %7.2fx %11zu\n", n, scalarUs, simdUs, scalarUs / simdUs, mismatches);
+    }
+    std::printf("%s\n", ok ? "bit-identical" : "PATHS DIFFER");
+    return ok ? 0 : 1;
+}
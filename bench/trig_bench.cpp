@@ -0,0 +1,152 @@
+//
+//  trig_bench.cpp
+//  Fish-Fillet-Project
+//
+//  Per-frame CPU cost of generating the wave, coral and fish vertices with
+//  inline cos/sin (how the shape code used to work) against the trig
+//  tables and the fish template. Vertices go to a plain buffer, so no GL
+//  context is needed and only the CPU side is measured.
+//
+//  cmake --build build --target trig_bench
+//
+
+#include "game_config.h"
+#include "trig_tables.h"
+#include "fish_mesh.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+const int WAVE_SEGMENTS = 100;
+const int WAVE_SPACING = 60;
+const int CORAL_COUNT = 14;
+
+static std::vector<float> sink;
+
+static void emit(float x, float y) {
+    sink.push_back(x);
+    sink.push_back(y);
+}
+
+// --- Inline trig, as drawWave / drawCoral / Fish::draw computed it -------
+
+static void waveInline(float cx, float cy, float radius, int waveDelta) {
+    for (int i = 0; i < WAVE_SEGMENTS; i++) {
+        float theta = 2.0f * PI * float(i) / float(WAVE_SEGMENTS);
+        emit(radius * std::cos(theta - 44.92f) + cx, radius * std::sin(theta - 44.92f) + cy + waveDelta);
+    }
+}
+
+static void coralInline(float coralPhase) {
+    for (int i = 0; i < CORAL_COUNT; ++i) {
+        float x = 40.0f + i * (WINDOW_WIDTH / static_cast<float>(CORAL_COUNT));
+        float sway = std::sin(coralPhase + i * 0.6f) * 8.0f;
+        float height = 60.0f + std::sin(coralPhase * 0.8f + i) * 20.0f;
+        emit(x + sway, height);
+    }
+}
+
+static void fishInline(float x, float y, float dir, float scale) {
+    float bodyLength = FISH_SIZE * 1.8f * scale;
+    float bodyHeight = FISH_SIZE * 1.2f * scale;
+    for (int pass = 0; pass < 2; ++pass) {  // Fill and outline
+        for (int i = 0; i <= 20; i++) {
+            float angle = PI * float(i) / 20.0f;
+            emit(x + dir * (bodyLength * 0.4f * std::cos(angle)), y + bodyHeight * 0.5f * std::sin(angle));
+        }
+    }
+    float tailBaseX = x - dir * bodyLength * 0.5f;
+    float tailLength = FISH_SIZE * 0.6f * scale;
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i <= 8; i++) {
+            float angle = (PI / 3.0f) * float(i) / 8.0f - (PI / 6.0f);
+            emit(tailBaseX - dir * tailLength * std::cos(angle), y + tailLength * std::sin(angle));
+        }
+    }
+    float eyeX = x + dir * bodyLength * 0.35f;
+    float eyeY = y + bodyHeight * 0.15f;
+    float eyeSize = FISH_SIZE * 0.15f * scale;
+    for (int pass = 0; pass < 2; ++pass) {
+        float r = pass == 0 ? eyeSize : eyeSize * 0.6f;
+        for (int i = 0; i <= 12; i++) {
+            float angle = 2.0f * PI * float(i) / 12.0f;
+            emit(eyeX + r * std::cos(angle), eyeY + r * std::sin(angle));
+        }
+    }
+}
+
+// --- Tabled ---------------------------------------------------------------
+
+static void waveTabled(float cx, float cy, float radius, int waveDelta) {
+    static const TrigTable& wave = arcTable(WAVE_SEGMENTS, -44.92f, 2.0f * PI);
+    for (int i = 0; i < WAVE_SEGMENTS; i++) {
+        emit(radius * wave.cosv[i] + cx, radius * wave.sinv[i] + cy + waveDelta);
+    }
+}
+
+static void coralTabled(float coralPhase) {
+    static const TrigTable& swayOffset = arcTable(CORAL_COUNT, 0.0f, 0.6f * CORAL_COUNT);
+    static const TrigTable& heightOffset = arcTable(CORAL_COUNT, 0.0f, static_cast<float>(CORAL_COUNT));
+    float swaySin = std::sin(coralPhase), swayCos = std::cos(coralPhase);
+    float heightSin = std::sin(coralPhase * 0.8f), heightCos = std::cos(coralPhase * 0.8f);
+    for (int i = 0; i < CORAL_COUNT; ++i) {
+        float x = 40.0f + i * (WINDOW_WIDTH / static_cast<float>(CORAL_COUNT));
+        float sway = (swaySin * swayOffset.cosv[i] + swayCos * swayOffset.sinv[i]) * 8.0f;
+        float height = 60.0f + (heightSin * heightOffset.cosv[i] + heightCos * heightOffset.sinv[i]) * 20.0f;
+        emit(x + sway, height);
+    }
+}
+
+// --- Driver -----------------------------------------------------------------
+
+template <class Frame>
+static double microsPerFrame(Frame frame, int frames) {
+    Clock::time_point start = Clock::now();
+    for (int f = 0; f < frames; ++f) {
+        sink.clear();
+        frame(f);
+    }
+    std::chrono::duration<double, std::micro> elapsed = Clock::now() - start;
+    return elapsed.count() / frames;
+}
+
+int main() {
+    const int frames = 2000;
+    sink.reserve(1 << 20);
+
+    double oceanInline = microsPerFrame([](int f) {
+        for (int i = 0; i <= WINDOW_WIDTH; i += WAVE_SPACING) waveInline(i, OCEAN_HEIGHT, 40, f % 31 - 15);
+        for (int i = 30; i <= WINDOW_WIDTH; i += WAVE_SPACING) waveInline(i, OCEAN_HEIGHT, 35, f % 31 - 15);
+        coralInline(f * 0.025f);
+    }, frames);
+    double oceanTabled = microsPerFrame([](int f) {
+        for (int i = 0; i <= WINDOW_WIDTH; i += WAVE_SPACING) waveTabled(i, OCEAN_HEIGHT, 40, f % 31 - 15);
+        for (int i = 30; i <= WINDOW_WIDTH; i += WAVE_SPACING) waveTabled(i, OCEAN_HEIGHT, 35, f % 31 - 15);
+        coralTabled(f * 0.025f);
+    }, frames);
+    std::printf("%-24s inline %9.2f us   tabled %9.2f us   (%.1fx)\n",
+                "waves + coral", oceanInline, oceanTabled, oceanInline / oceanTabled);
+
+    const int fishCounts[] = {20, 1000, 10000};
+    for (int n : fishCounts) {
+        int reps = n >= 10000 ? 50 : 500;
+        double fishOld = microsPerFrame([n](int) {
+            for (int i = 0; i < n; ++i) fishInline(float(i % WINDOW_WIDTH), 250.0f, (i & 1) ? 1.0f : -1.0f, 1.0f);
+        }, reps);
+        FishMesh mesh;
+        mesh.reserve(n);
+        const float yellow[3] = {1.0f, 0.9f, 0.2f};
+        double fishNew = microsPerFrame([n, &mesh, &yellow](int) {
+            mesh.clear();
+            for (int i = 0; i < n; ++i) mesh.addFish(float(i % WINDOW_WIDTH), 250.0f, (i & 1) ? 1.0f : -1.0f, 1.0f, yellow);
+        }, reps);
+        char label[32];
+        std::snprintf(label, sizeof(label), "fish x %d", n);
+        std::printf("%-24s inline %9.2f us   tabled %9.2f us   (%.1fx)\n",
+                    label, fishOld, fishNew, fishOld / fishNew);
+    }
+    return 0;
+}
@@ -0,0 +1,154 @@
+//
+//  world_state_bench.cpp
+//  Fish-Fillet-Project
+//
+//  Save states (world_state.h): time to capture a world and to restore it
+//  into another, and the size of the state, for 1k, 10k and 100k fish in
+//  one window. Then checks that a restored world carries on exactly:
+//
+//  - resume: capture a round part way, restore it into a fresh World, tick
+//    both on with the same input and compare their states byte for byte.
+//    Run on the default ocean and on a scrolling one whose camera keeps
+//    moving, so chunks wake and fall asleep around the save.
+//  - file: save a state, load it back and compare.
+//
+//  Exits with 1 if either check fails.
+//
+//  cmake --build build --target world_state_bench
+//  ./world_state_bench
+//
+
+#include "world.h"
+#include "world_state.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+
+typedef std::chrono::steady_clock Clock;
+
+const long RESUME_TICK = 400;    // Ticks played before the save
+const long RESUME_TICKS = 600;   // Ticks played on after it
+
+// A player big enough to eat anything it meets, so the round outlasts the
+// checks instead of ending at the first large fish
+static std::shared_ptr<const Level> levelWith(uint32_t fishCount, float worldWidth, float worldHeight) {
+    LevelRules rules = defaultLevel()->rules;
+    rules.fishCount = fishCount;
+    rules.initialPlayerSize = rules.maxPlayerSize = 2.0f;
+    rules.worldWidth = worldWidth;
+    rules.worldHeight = worldHeight;
+    std::string error;
+    return defaultLevel()->withRules(rules, error);
+}
+
+static bool sameState(const WorldState& a, const WorldState& b) {
+    return a.byteCount() == b.byteCount() && std::memcmp(a.data(), b.data(), a.byteCount()) == 0;
+}
+
+// Mouse sweeping along the right edge, so a scrolling world keeps scrolling
+static void steer(World& world, long tick) {
+    world.mouseMove(WINDOW_WIDTH - 10.0f, 100.0f + (tick % 300));
+}
+
+// Play RESUME_TICK ticks, save, and play on both in the original and in a
+// fresh World restored from the save; true if they end the same
+static bool resumesExactly(const std::shared_ptr<const Level>& level, const char* name) {
+    World original(7);
+    original.setLevel(level);
+    original.reset();
+    for (long t = 0; t < RESUME_TICK; ++t) {
+        steer(original, t);
+        original.tick();
+    }
+    WorldState saved;
+    saved.capture(original);
+
+    World resumed(99);  // Another seed sequence, so nothing matches by chance
+    resumed.setLevel(level);
+    std::string error;
+    if (!saved.restore(resumed, error)) {
+        std::printf("%-8s restore failed: %s\n", name, error.c_str());
+        return false;
+    }
+    for (long t = RESUME_TICK; t < RESUME_TICK + RESUME_TICKS; ++t) {
+        steer(original, t);
+        original.tick();
+        steer(resumed, t);
+        resumed.tick();
+    }
+    int finalScore = original.score;
+    WorldState a, b;
+    a.capture(original);
+    b.capture(resumed);
+    bool same = sameState(a, b);
+
+    // The next round must come from the same seed too
+    original.reset();
+    resumed.reset();
+    for (long t = 0; t < 50; ++t) {
+        original.tick();
+        resumed.tick();
+    }
+    a.capture(original);
+    b.capture(resumed);
+    same = sameState(a, b) && same;
+    std::printf("%-8s resume after tick %ld: %s (%u fish awake, %u asleep at the save; score %d at tick %ld)\n",
+                name, RESUME_TICK, same ? "identical" : "DIFFERENT", saved.header().fishCount,
+                saved.header().sleepingCount, finalScore, RESUME_TICK + RESUME_TICKS);
+    return same;
+}
+
+static bool fileRoundTrip(const std::shared_ptr<const Level>& level) {
+    World world(3);
+    world.setLevel(level);
+    world.reset();
+    for (long t = 0; t < RESUME_TICK; ++t) {
+        steer(world, t);
+        world.tick();
+    }
+    WorldState saved, loaded;
+    saved.capture(world);
+    const char* path = "world_state_bench.state";
+    std::string error;
+    bool ok = saved.save(path, error) && loaded.load(path, error);
+    std::remove(path);
+    ok = ok && sameState(saved, loaded);
+    std::printf("file     save and load: %s%s\n", ok ? "identical" : "FAILED ", ok ? "" : error.c_str());
+    return ok;
+}
+
+int main() {
+    const uint32_t counts[] = {1000, 10000, 100000};
+
+    std::printf("%8s %12s %12s %10s %12s\n", "fish", "capture us", "restore us", "KB", "bytes/fish");
+    for (uint32_t n : counts) {
+        std::shared_ptr<const Level> level = levelWith(n, WINDOW_WIDTH, OCEAN_HEIGHT);
+        World world(1), target(2);
+        world.setLevel(level);
+        target.setLevel(level);
+        int passes = n >= 100000 ? 100 : 1000;
+
+        // Once untimed, so both sides have their storage
+        WorldState state;
+        std::string error;
+        state.capture(world);
+        state.restore(target, error);
+
+        Clock::time_point t0 = Clock::now();
+        for (int p = 0; p < passes; ++p) state.capture(world);
+        Clock::time_point t1 = Clock::now();
+        for (int p = 0; p < passes; ++p) state.restore(target, error);
+        Clock::time_point t2 = Clock::now();
+
+        std::chrono::duration<double, std::micro> capture = t1 - t0, restore = t2 - t1;
+        std::printf("%8u %12.1f %12.1f %10.1f %12.2f\n", n, capture.count() / passes, restore.count() / passes,
+                    state.byteCount() / 1024.0, double(state.byteCount()) / n);
+    }
+
+    bool ok = resumesExactly(levelWith(1000, WINDOW_WIDTH, OCEAN_HEIGHT), "window");
+    ok = resumesExactly(levelWith(8000, 12000.0f, 5000.0f), "scroll") && ok;
+    ok = fileRoundTrip(levelWith(8000, 12000.0f, 5000.0f)) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,126 @@
+//
+//  bot_player.cpp
+//  Fish-Fillet-Project
+//
+
+#include "bot_player.h"
+#include "world.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+static const char* const BOT_NAMES[BOT_KIND_COUNT] = {"parked", "scripted", "greedy"};
+
+const char* botName(BotKind kind) {
+    return kind >= 0 && kind < BOT_KIND_COUNT ? BOT_NAMES[kind] : "unknown";
+}
+
+bool parseBot(const char* name, BotKind& kind) {
+    for (int k = 0; k < BOT_KIND_COUNT; ++k) {
+        if (std::strcmp(name, BOT_NAMES[k]) == 0) {
+            kind = static_cast<BotKind>(k);
+            return true;
+        }
+    }
+    return false;
+}
+
+BotPlayer::BotPlayer(BotKind kind)
+    : botKind(kind), x(0.0f), y(0.0f), maxX(WINDOW_WIDTH), maxY(OCEAN_HEIGHT), ticks(0) {}
+
+void BotPlayer::reset(const World& world) {
+    x = world.player.x;
+    y = world.player.y;
+    maxX = world.level->rules.worldWidth;
+    maxY = world.level->rules.worldHeight;
+    ticks = 0;
+}
+
+void BotPlayer::steer(World& world) {
+    ++ticks;
+    if (botKind == BOT_PARKED) return;  // No input at all, as before bots existed
+    if (botKind == BOT_SCRIPTED) {
+        // A Lissajous figure through the middle of the ocean; its top speed
+        // is just under BOT_SPEED, so the bot keeps up with it
+        float t = ticks * SIM_DT;
+        float targetX = maxX * 0.5f + (maxX * 0.5f - 80.0f) * std::sin(0.7f * t);
+        float targetY = maxY * 0.5f + (maxY * 0.5f - 40.0f) * std::sin(1.1f * t);
+        moveToward(targetX, targetY);
+    } else {
+        steerGreedy(world);
+    }
+    if (!world.scrolling()) {
+        world.mouseMove(x, WINDOW_HEIGHT - y);  // Back to window coordinates, like GLUT's
+        return;
+    }
+    // The mouse cannot leave the window; past the edge it scrolls the view
+    // instead, so pick up wherever that actually left the player
+    float mouseX = std::min(std::max(x - world.cameraX, 0.0f), static_cast<float>(WINDOW_WIDTH));
+    float mouseY = std::min(std::max(WINDOW_HEIGHT - (y - world.cameraY), 0.0f), static_cast<float>(WINDOW_HEIGHT));
+    world.mouseMove(mouseX, mouseY);
+    x = world.player.x;
+    y = world.player.y;
+}
+
+void BotPlayer::moveToward(float targetX, float targetY) {
+    float dx = targetX - x;
+    float dy = targetY - y;
+    float distance = std::sqrt(dx * dx + dy * dy);
+    if (distance <= BOT_SPEED) {
+        x = targetX;
+        y = targetY;
+    } else {
+        x += dx * (BOT_SPEED / distance);
+        y += dy * (BOT_SPEED / distance);
+    }
+    x = std::min(std::max(x, 0.0f), maxX);
+    y = std::min(std::max(y, 0.0f), maxY);
+}
+
+// Chase the nearest fish the player can eat right now, pushed off course by
+// every fish it cannot eat that is within BOT_DANGER_MARGIN of touching.
+// With nothing edible awake, head for the nearest chunk of sleeping fish.
+void BotPlayer::steerGreedy(const World& world) {
+    const FishStore& fish = world.fish;
+    float playerRadius = world.playerRadius();
+    int prey = -1;
+    float preyDistance2 = 0.0f;
+    float awayX = 0.0f, awayY = 0.0f;
+    for (size_t i = 0, n = fish.size(); i < n; ++i) {
+        float dx = fish.x[i] - x;
+        float dy = fish.y[i] - y;
+        float d2 = dx * dx + dy * dy;
+        if (world.canEatFish(i)) {
+            if (prey < 0 || d2 < preyDistance2) {
+                prey = static_cast<int>(i);
+                preyDistance2 = d2;
+            }
+            continue;
+        }
+        float reach = playerRadius + fish.collisionRadius(i) + BOT_DANGER_MARGIN;
+        if (d2 >= reach * reach || d2 == 0.0f) continue;
+        float d = std::sqrt(d2);
+        float push = (reach - d) / BOT_DANGER_MARGIN;  // 0 at the edge, over 1 once touching
+        awayX -= dx / d * push;
+        awayY -= dy / d * push;
+    }
+
+    float chunkX, chunkY;
+    bool roam = prey < 0 && world.scrolling() && world.chunks.nearestSleeping(x, y, chunkX, chunkY);
+    if (awayX == 0.0f && awayY == 0.0f) {
+        if (prey >= 0) moveToward(fish.x[prey], fish.y[prey]);
+        else if (roam) moveToward(chunkX, chunkY);
+        return;
+    }
+    float steerX = 2.0f * awayX;
+    float steerY = 2.0f * awayY;
+    if (prey >= 0) {
+        float d = std::sqrt(preyDistance2);
+        if (d > 0.0f) {
+            steerX += (fish.x[prey] - x) / d;
+            steerY += (fish.y[prey] - y) / d;
+        }
+    }
+    float length = std::sqrt(steerX * steerX + steerY * steerY);
+    if (length > 0.0f) moveToward(x + steerX / length * BOT_SPEED, y + steerY / length * BOT_SPEED);
+}
@@ -0,0 +1,58 @@
+//
+//  bot_player.h
+//  Fish-Fillet-Project
+//
+//  Scripted stand-ins for the mouse, for running rounds with nobody at the
+//  window. A bot reads the World it is playing and feeds it one mouse
+//  position per tick through World::mouseMove, exactly like the GLUT
+//  handler, so every rule and collision path is the one a player hits.
+//  Bots move the mouse at most BOT_SPEED pixels a tick, a quick but human
+//  hand, and use no randomness of their own: a round is still fixed by its
+//  seed. In a scrolling world they steer in ocean coordinates and let the
+//  mouse sit in the edge band to scroll, as a player would.
+//
+
+#ifndef BOT_PLAYER_H
+#define BOT_PLAYER_H
+
+class World;
+
+enum BotKind {
+    BOT_PARKED = 0,     // Never moves; the old --headless player
+    BOT_SCRIPTED = 1,   // Sweeps a fixed figure across the ocean, blind to fish
+    BOT_GREEDY = 2,     // Heads for the nearest fish it can eat, shies from the rest
+    BOT_KIND_COUNT = 3
+};
+
+const float BOT_SPEED = 8.0f;           // Pixels per tick (400 px/s)
+const float BOT_DANGER_MARGIN = 60.0f;  // Greedy bot keeps this much clear of bigger fish
+
+// Name used on the command line and in CSV output
+const char* botName(BotKind kind);
+
+// Parse a bot name; false if unknown
+bool parseBot(const char* name, BotKind& kind);
+
+class BotPlayer {
+public:
+    explicit BotPlayer(BotKind kind = BOT_GREEDY);
+
+    BotKind kind() const { return botKind; }
+
+    // Start a round from wherever the world's player is now
+    void reset(const World& world);
+
+    // Pick this tick's mouse position and send it to the world
+    void steer(World& world);
+
+private:
+    BotKind botKind;
+    float x, y;         // Where the bot has the player, in ocean coordinates
+    float maxX, maxY;   // Ocean size
+    long ticks;
+
+    void moveToward(float targetX, float targetY);
+    void steerGreedy(const World& world);
+};
+
+#endif // BOT_PLAYER_H
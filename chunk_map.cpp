@@ -0,0 +1,129 @@
+//
+//  chunk_map.cpp
+//  Fish-Fillet-Project
+//
+
+#include "chunk_map.h"
+#include <algorithm>
+#include <cmath>
+
+ChunkMap::ChunkMap()
+    : worldWidth(0.0f), worldHeight(0.0f), cols(0), rows(0),
+      minCol(0), maxCol(-1), minRow(0), maxRow(-1), freeHead(-1), sleeping(0) {}
+
+void ChunkMap::reset(float width, float height, size_t fishCount) {
+    worldWidth = width;
+    worldHeight = height;
+    cols = std::max(1, static_cast<int>(std::ceil(width / CHUNK_SIZE)));
+    rows = std::max(1, static_cast<int>(std::ceil(height / CHUNK_SIZE)));
+    Chunk empty = {-1, 0};
+    chunks.assign(cols * rows, empty);
+
+    // Every slot starts on the free list; assign() keeps capacity, so a
+    // restart of the same level does not allocate
+    pool.assign(fishCount, Fish(false));
+    sleptAt.assign(fishCount, 0);
+    next.resize(fishCount);
+    for (size_t s = 0; s < fishCount; ++s) next[s] = s + 1 < fishCount ? static_cast<int>(s + 1) : -1;
+    freeHead = fishCount > 0 ? 0 : -1;
+    sleeping = 0;
+    minCol = minRow = 0;
+    maxCol = maxRow = -1;
+}
+
+int ChunkMap::columnOf(float x) const {
+    int col = static_cast<int>(std::floor(x / CHUNK_SIZE));
+    return std::min(std::max(col, 0), cols - 1);
+}
+
+int ChunkMap::rowOf(float y) const {
+    int row = static_cast<int>(std::floor(y / CHUNK_SIZE));
+    return std::min(std::max(row, 0), rows - 1);
+}
+
+int ChunkMap::awakeCount() const {
+    if (maxCol < minCol || maxRow < minRow) return 0;
+    return (maxCol - minCol + 1) * (maxRow - minRow + 1);
+}
+
+void ChunkMap::update(FishStore& fish, float viewX, float viewY, float viewWidth, float viewHeight, long tick) {
+    int oldMinCol = minCol, oldMaxCol = maxCol, oldMinRow = minRow, oldMaxRow = maxRow;
+    minCol = std::max(columnOf(viewX) - AWAKE_CHUNK_MARGIN, 0);
+    maxCol = std::min(columnOf(viewX + viewWidth) + AWAKE_CHUNK_MARGIN, cols - 1);
+    minRow = std::max(rowOf(viewY) - AWAKE_CHUNK_MARGIN, 0);
+    maxRow = std::min(rowOf(viewY + viewHeight) + AWAKE_CHUNK_MARGIN, rows - 1);
+
+    // Fish outside the awake chunks go to sleep where they are. Walk down
+    // so swap-and-pop only ever moves a fish that was already checked.
+    for (size_t i = fish.size(); i-- > 0; ) {
+        int col = columnOf(fish.x[i]);
+        int row = rowOf(fish.y[i]);
+        if (!awake(col, row)) sleep(fish, i, row * cols + col, tick);
+    }
+
+    for (int row = minRow; row <= maxRow; ++row) {
+        for (int col = minCol; col <= maxCol; ++col) {
+            bool wasAwake = col >= oldMinCol && col <= oldMaxCol && row >= oldMinRow && row <= oldMaxRow;
+            if (!wasAwake) wake(fish, col, row, tick);
+        }
+    }
+}
+
+void ChunkMap::sleep(FishStore& fish, size_t i, int chunk, long tick) {
+    putToSleep(chunk, fish.get(i), tick);
+    fish.remove(i);
+}
+
+void ChunkMap::putToSleep(int chunk, const Fish& f, long tick) {
+    int slot = freeHead;
+    freeHead = next[slot];
+    pool[slot] = f;
+    sleptAt[slot] = tick;
+    next[slot] = chunks[chunk].head;
+    chunks[chunk].head = slot;
+    ++chunks[chunk].count;
+    ++sleeping;
+}
+
+// Catch each fish up on the drift it missed, wrapped so it stays in its
+// chunk, and hand it back to the store
+void ChunkMap::wake(FishStore& fish, int col, int row, long tick) {
+    Chunk& chunk = chunks[row * cols + col];
+    float left = col * CHUNK_SIZE;
+    float width = std::min(CHUNK_SIZE, worldWidth - left);
+    int slot = chunk.head;
+    while (slot >= 0) {
+        Fish f = pool[slot];
+        float drift = f.direction * static_cast<float>(tick - sleptAt[slot]);
+        float offset = std::fmod(f.x + drift - left, width);
+        if (offset < 0.0f) offset += width;
+        f.x = left + offset;
+        fish.push(f);
+
+        int following = next[slot];
+        next[slot] = freeHead;
+        freeHead = slot;
+        slot = following;
+    }
+    sleeping -= chunk.count;
+    chunk.head = -1;
+    chunk.count = 0;
+}
+
+bool ChunkMap::nearestSleeping(float x, float y, float& chunkX, float& chunkY) const {
+    float best = -1.0f;
+    for (int row = 0; row < rows; ++row) {
+        for (int col = 0; col < cols; ++col) {
+            if (chunks[row * cols + col].count == 0) continue;
+            float cx = (col + 0.5f) * CHUNK_SIZE;
+            float cy = (row + 0.5f) * CHUNK_SIZE;
+            float d2 = (cx - x) * (cx - x) + (cy - y) * (cy - y);
+            if (best < 0.0f || d2 < best) {
+                best = d2;
+                chunkX = cx;
+                chunkY = cy;
+            }
+        }
+    }
+    return best >= 0.0f;
+}
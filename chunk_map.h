@@ -0,0 +1,118 @@
+//
+//  chunk_map.h
+//  Fish-Fillet-Project
+//
+//  Streaming for oceans larger than the window. The world is cut into
+//  CHUNK_SIZE squares; the chunks under the camera, plus a margin of
+//  AWAKE_CHUNK_MARGIN all round, are awake and their fish live in the
+//  World's FishStore, where they get the full behavior, flocking and
+//  collision update. Every other chunk is asleep: its fish wait in a fixed
+//  pool, cost nothing per tick, and are not drawn.
+//
+//  When a chunk wakes, each of its fish is advanced by the plain drift it
+//  would have made while asleep and wrapped back into the chunk. Fish going
+//  out of a sleeping chunk are balanced by fish coming in, so the
+//  population and the spread of positions look the same as if every fish
+//  had kept swimming. A fish that swims from an awake chunk into a sleeping
+//  one goes to sleep with it.
+//
+//  Per tick the map only looks at awake fish, and a chunk changes state
+//  only at the edge of the awake region, so the cost follows the number of
+//  fish near the camera, not the size of the world. The pool is sized when
+//  a round starts and never grows, so streaming does not allocate.
+//
+
+#ifndef CHUNK_MAP_H
+#define CHUNK_MAP_H
+
+#include "fish_store.h"
+#include <cstddef>
+#include <vector>
+
+const float CHUNK_SIZE = 400.0f;
+const int AWAKE_CHUNK_MARGIN = 1;   // Covers the chase distance beyond the view
+
+class ChunkMap {
+public:
+    ChunkMap();
+
+    // Lay chunks over a world of this size with room for fishCount fish.
+    // Every chunk starts asleep and empty; the first update() sends the
+    // store's fish that are not near the view to sleep.
+    void reset(float worldWidth, float worldHeight, size_t fishCount);
+
+    // Wake the chunks near the view rectangle and put the rest to sleep,
+    // moving fish between the store and the pool as needed
+    void update(FishStore& fish, float viewX, float viewY, float viewWidth, float viewHeight, long tick);
+
+    // Widest awake region along an axis for a view this long: the chunks a
+    // view can straddle plus the margin on both sides
+    static float awakeSpan(float viewLength) {
+        return (static_cast<int>(viewLength / CHUNK_SIZE) + 2 + 2 * AWAKE_CHUNK_MARGIN) * CHUNK_SIZE;
+    }
+
+    // Lower corner of the awake region, for placing grids over it
+    float awakeX() const { return minCol * CHUNK_SIZE; }
+    float awakeY() const { return minRow * CHUNK_SIZE; }
+
+    int chunkCount() const { return cols * rows; }
+    int awakeCount() const;
+    size_t sleepingFish() const { return sleeping; }
+
+    // Save states (world_state.h): visit every sleeping fish as
+    // visit(chunk, fish, tickItFellAsleep), chunk by chunk in list order
+    template <class Visit>
+    void forEachSleeping(Visit visit) const {
+        for (int c = 0; c < cols * rows; ++c) {
+            for (int slot = chunks[c].head; slot >= 0; slot = next[slot]) visit(c, pool[slot], sleptAt[slot]);
+        }
+    }
+
+    // Put a fish to sleep at the head of a chunk's list. Adding what
+    // forEachSleeping visited in reverse rebuilds the same lists.
+    void putToSleep(int chunk, const Fish& f, long tick);
+
+    // Awake chunks, inclusive, as saved and restored with the sleeping fish
+    void awakeRegion(int& firstCol, int& lastCol, int& firstRow, int& lastRow) const {
+        firstCol = minCol;
+        lastCol = maxCol;
+        firstRow = minRow;
+        lastRow = maxRow;
+    }
+    void setAwakeRegion(int firstCol, int lastCol, int firstRow, int lastRow) {
+        minCol = firstCol;
+        maxCol = lastCol;
+        minRow = firstRow;
+        maxRow = lastRow;
+    }
+
+    // Centre of the nearest chunk (by centre distance) that has sleeping
+    // fish; false when every remaining fish is awake
+    bool nearestSleeping(float x, float y, float& chunkX, float& chunkY) const;
+
+private:
+    struct Chunk {
+        int head;       // First pool slot of this chunk's sleeping fish, or -1
+        int count;
+    };
+
+    float worldWidth, worldHeight;
+    int cols, rows;
+    int minCol, maxCol, minRow, maxRow;     // Awake chunks, inclusive; empty when max < min
+    std::vector<Chunk> chunks;
+    std::vector<Fish> pool;                 // Sleeping fish, linked per chunk
+    std::vector<long> sleptAt;              // Tick each pooled fish fell asleep
+    std::vector<int> next;                  // Next slot in the chunk's list, or the free list
+    int freeHead;
+    size_t sleeping;
+
+    int columnOf(float x) const;
+    int rowOf(float y) const;
+    bool awake(int col, int row) const {
+        return col >= minCol && col <= maxCol && row >= minRow && row <= maxRow;
+    }
+    void sleep(FishStore& fish, size_t i, int chunk, long tick);
+    void wake(FishStore& fish, int col, int row, long tick);
+};
+
+#endif // CHUNK_MAP_H
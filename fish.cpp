@@ -0,0 +1,93 @@
+//
+//  fish.cpp
+//  Fish-Fillet-Project
+//
+
+#include "fish.h"
+#include <cmath>
+
+Fish::Fish(bool player) : isPlayer(player), isRedFish(false) {
+    x = WINDOW_WIDTH / 2.0f;
+    y = WINDOW_HEIGHT / 2.0f;
+    sizeScale = INITIAL_PLAYER_SIZE;
+    species = MEDIUM;
+    direction = FISH_SPEED;  // Default direction for player (right)
+}
+
+Fish::Fish(Rng& rng, const LevelRules& rules) : isPlayer(false) {
+    // Red with odds red : yellow, then a species by weight. The default
+    // level's 3 : 7 and 4 : 4 : 2 give 30% red and 40/40/20 small/medium/large.
+    isRedFish = rng.nextInt(rules.redWeight + rules.yellowWeight) < rules.redWeight;
+    int totalWeight = 0;
+    for (int s = 0; s < rules.speciesCount; ++s) totalWeight += rules.species[s].weight;
+    int roll = rng.nextInt(totalWeight);
+    species = 0;
+    while (roll >= rules.species[species].weight) {
+        roll -= rules.species[species].weight;
+        ++species;
+    }
+    sizeScale = rules.species[species].scale;
+    // Position will be assigned later ensuring safe spawn distance from player
+    x = 0.0f;
+    y = 0.0f;
+    direction = rng.nextInt(2) * FISH_SPEED - (FISH_SPEED / 2.0f);
+}
+
+void Fish::move(float toX, float toY, float prevX) {
+    // Update direction based on mouse movement
+    if (toX > prevX) {
+        direction = FISH_SPEED;  // Moving right
+    } else if (toX < prevX) {
+        direction = -FISH_SPEED;  // Moving left
+    }
+    // If toX == prevX, keep current direction
+
+    x = toX;
+    y = toY;
+}
+
+void Fish::moveWithBehavior(float playerX, float playerY, float playerRadius, const BehaviorParams& params,
+                            Rng& rng) {
+    if (isPlayer) return;
+
+    float dx = playerX - x;
+    float dy = playerY - y;
+    float dist2 = dx * dx + dy * dy;
+    float myRadius = getCollisionRadius();
+
+    // Default drift
+    float stepX = direction;
+    float stepY = 0.0f;
+
+    // Flee if player is bigger and close (applies to ALL fish - yellow and red)
+    if (playerRadius > myRadius * 0.9f && dist2 < params.fleeDistance2) {
+        float norm = std::sqrt(dist2) + 0.001f;
+        stepX = -(dx / norm) * FISH_SPEED * params.fleeSpeedMult * 2.0f;
+        stepY = -(dy / norm) * FISH_SPEED * params.fleeSpeedMult * 2.0f;
+        direction = (stepX < 0) ? -FISH_SPEED : FISH_SPEED;
+    }
+    // Chase only if this fish is bigger (red or a chasing species) and player is smaller
+    else if ((isRedFish || params.chases[species]) && playerRadius < myRadius * 0.95f && dist2 < params.chaseDistance2) {
+        float norm = std::sqrt(dist2) + 0.001f;
+        stepX = (dx / norm) * FISH_SPEED * params.chaseSpeedMult * 2.0f;
+        stepY = (dy / norm) * FISH_SPEED * params.chaseSpeedMult * 2.0f;
+        direction = (stepX < 0) ? -FISH_SPEED : FISH_SPEED;
+    }
+
+    x += stepX;
+    y += stepY;
+
+    // Wrap horizontally
+    if (x > params.worldWidth) {
+        x -= params.worldWidth;
+        y = static_cast<float>(rng.nextInt(static_cast<int>(params.worldHeight)));
+    }
+    if (x < 0) {
+        x += params.worldWidth;
+        y = static_cast<float>(rng.nextInt(static_cast<int>(params.worldHeight)));
+    }
+
+    // Clamp vertical movement to stay in ocean
+    if (y < 40) y = 40;
+    if (y > params.worldHeight - 30) y = params.worldHeight - 30;
+}
@@ -0,0 +1,50 @@
+//
+//  fish.h
+//  Fish-Fillet-Project
+//
+
+#ifndef FISH_H
+#define FISH_H
+
+#include "game_config.h"
+#include "level.h"
+#include "rng.h"
+
+// Fish Class
+class Fish {
+public:
+    bool isPlayer;
+    bool isRedFish;
+    int species;      // Index into the level's species table
+    float x, y;
+    float direction;
+    float sizeScale;  // Individual size scale for this fish
+
+    // The player fish
+    explicit Fish(bool player);
+
+    // A random non-player fish drawn from the level's spawn weights;
+    // position is assigned by the spawner
+    Fish(Rng& rng, const LevelRules& rules);
+
+    // Rebuild a non-player fish from stored fields without rolling new ones
+    Fish(float x, float y, float direction, float sizeScale, bool isRedFish, int species)
+        : isPlayer(false), isRedFish(isRedFish), species(species),
+          x(x), y(y), direction(direction), sizeScale(sizeScale) {}
+
+    // Get effective size for collision detection
+    float getCollisionRadius() const {
+        return COLLISION_RADIUS * sizeScale;
+    }
+
+    // Player only: jump to the mouse, given in ocean coordinates, and face
+    // the way it moved
+    void move(float toX, float toY, float prevX);
+
+    // Movement with simple behavior: flee smaller fish, chase bigger/red fish.
+    // Reference version of the batched kernel in behavior_kernel.cpp.
+    void moveWithBehavior(float playerX, float playerY, float playerRadius, const BehaviorParams& params,
+                          Rng& rng);
+};
+
+#endif // FISH_H
@@ -0,0 +1,273 @@
+//
+//  fish_mesh.cpp
+//  Fish-Fillet-Project
+//
+
+#include "fish_mesh.h"
+#include "world_snapshot.h"
+#include "trig_tables.h"
+
+// Which colour a template vertex takes
+enum FishShade {
+    SHADE_BODY = 0,   // Base colour
+    SHADE_TAIL = 1,   // Base * 0.8
+    SHADE_FIN = 2,    // Base * 0.9
+    SHADE_WHITE = 3,  // Eye white
+    SHADE_BLACK = 4,  // Pupil and outlines
+    SHADE_COUNT = 5
+};
+
+struct TemplateVertex {
+    float x, y;  // Offset from the fish centre at scale 1, facing right
+    int shade;
+};
+
+// Tessellation of the drawn levels; FISH_LOD_FULL is the original shape
+struct FishDetail {
+    int bodySegments;
+    int tailSegments;
+    int eyeSegments;  // 0 for no eyes
+    bool fins;
+    bool outlines;
+};
+
+static const FishDetail FISH_DETAIL[FISH_LOD_IMPOSTOR] = {
+    {20, 8, 12, true, true},
+    {10, 4, 6, true, true},
+    {6, 3, 0, false, false},
+};
+
+const float BODY_LENGTH = FISH_SIZE * 1.8f;
+const float BODY_HEIGHT = FISH_SIZE * 1.2f;
+const float TAIL_LENGTH = FISH_SIZE * 0.6f;
+const float BODY_RADIUS = BODY_LENGTH * 0.4f;  // Half the body's length at scale 1
+
+struct FishTemplate {
+    std::vector<TemplateVertex> fills;
+    std::vector<TemplateVertex> bodyLines;
+    std::vector<TemplateVertex> tailLines;
+
+    explicit FishTemplate(FishLod lod) {
+        const float tailBaseX = -BODY_LENGTH * 0.5f;
+        if (lod == FISH_LOD_IMPOSTOR) {
+            // Nose, back, tail tip and belly; covers the body and most of the tail
+            float quadX[4] = {BODY_RADIUS, 0.0f, tailBaseX - TAIL_LENGTH, 0.0f};
+            float quadY[4] = {0.0f, BODY_HEIGHT * 0.5f, 0.0f, -BODY_HEIGHT * 0.25f};
+            addFan(fills, quadX, quadY, 4, SHADE_BODY);
+            return;
+        }
+        const FishDetail& detail = FISH_DETAIL[lod];
+
+        // Body (half ellipse), fanned from its first point
+        const int bodySegments = detail.bodySegments;
+        const TrigTable& half = halfCircleTable(bodySegments);
+        std::vector<float> bodyX(bodySegments + 1), bodyY(bodySegments + 1);
+        for (int i = 0; i <= bodySegments; i++) {
+            bodyX[i] = BODY_RADIUS * half.cosv[i];
+            bodyY[i] = BODY_HEIGHT * 0.5f * half.sinv[i];
+        }
+        addFan(fills, &bodyX[0], &bodyY[0], bodySegments + 1, SHADE_BODY);
+        if (detail.outlines) addLoop(bodyLines, &bodyX[0], &bodyY[0], bodySegments + 1);
+
+        // Tail fin (fan shape) at the back of the fish
+        const int tailSegments = detail.tailSegments;
+        const TrigTable& fan = arcTable(tailSegments, -(PI / 6.0f), PI / 3.0f);
+        std::vector<float> tailX(tailSegments + 2), tailY(tailSegments + 2);
+        tailX[0] = tailBaseX;
+        tailY[0] = 0.0f;
+        for (int i = 0; i <= tailSegments; i++) {
+            tailX[i + 1] = tailBaseX - TAIL_LENGTH * fan.cosv[i];
+            tailY[i + 1] = TAIL_LENGTH * fan.sinv[i];
+        }
+        addFan(fills, &tailX[0], &tailY[0], tailSegments + 2, SHADE_TAIL);
+        if (detail.outlines) addLoop(tailLines, &tailX[0], &tailY[0], tailSegments + 2);
+
+        // Dorsal and pelvic fins
+        if (detail.fins) {
+            for (int side = 1; side >= -1; side -= 2) {
+                add(fills, BODY_LENGTH * 0.1f, side * BODY_HEIGHT * 0.4f, SHADE_FIN);
+                add(fills, BODY_LENGTH * 0.3f, side * BODY_HEIGHT * 0.6f, SHADE_FIN);
+                add(fills, BODY_LENGTH * 0.2f, side * BODY_HEIGHT * 0.5f, SHADE_FIN);
+            }
+        }
+
+        // Eye white and pupil
+        const int eyeSegments = detail.eyeSegments;
+        if (eyeSegments == 0) return;
+        const float eyeX = BODY_LENGTH * 0.35f;
+        const float eyeY = BODY_HEIGHT * 0.15f;
+        const float eyeSize = FISH_SIZE * 0.15f;
+        const TrigTable& circle = circleTable(eyeSegments);
+        std::vector<float> circleX(eyeSegments + 1), circleY(eyeSegments + 1);
+        for (int pass = 0; pass < 2; ++pass) {
+            float radius = pass == 0 ? eyeSize : eyeSize * 0.6f;
+            for (int i = 0; i <= eyeSegments; i++) {
+                circleX[i] = eyeX + radius * circle.cosv[i];
+                circleY[i] = eyeY + radius * circle.sinv[i];
+            }
+            addFan(fills, &circleX[0], &circleY[0], eyeSegments + 1, pass == 0 ? SHADE_WHITE : SHADE_BLACK);
+        }
+    }
+
+    static void add(std::vector<TemplateVertex>& out, float x, float y, int shade) {
+        TemplateVertex v = {x, y, shade};
+        out.push_back(v);
+    }
+
+    // Convex polygon as a triangle fan around point 0
+    static void addFan(std::vector<TemplateVertex>& out, const float* xs, const float* ys, int n, int shade) {
+        for (int i = 1; i + 1 < n; ++i) {
+            add(out, xs[0], ys[0], shade);
+            add(out, xs[i], ys[i], shade);
+            add(out, xs[i + 1], ys[i + 1], shade);
+        }
+    }
+
+    // Closed outline as independent line segments
+    static void addLoop(std::vector<TemplateVertex>& out, const float* xs, const float* ys, int n) {
+        for (int i = 0; i < n; ++i) {
+            int j = (i + 1) % n;
+            add(out, xs[i], ys[i], SHADE_BLACK);
+            add(out, xs[j], ys[j], SHADE_BLACK);
+        }
+    }
+};
+
+static const FishTemplate& fishTemplate(FishLod lod) {
+    static const FishTemplate shapes[FISH_LOD_COUNT] = {
+        FishTemplate(FISH_LOD_FULL), FishTemplate(FISH_LOD_MEDIUM),
+        FishTemplate(FISH_LOD_SMALL), FishTemplate(FISH_LOD_IMPOSTOR)};
+    return shapes[lod];
+}
+
+static unsigned char toByte(float c) {
+    if (c <= 0.0f) return 0;
+    if (c >= 1.0f) return 255;
+    return static_cast<unsigned char>(c * 255.0f + 0.5f);
+}
+
+static void appendShape(std::vector<FishVertex>& out, const std::vector<TemplateVertex>& shape,
+                        float x, float y, float sx, float sy, const FishVertex palette[SHADE_COUNT]) {
+    size_t base = out.size();
+    out.resize(base + shape.size());
+    FishVertex* dst = &out[base];
+    for (size_t i = 0; i < shape.size(); ++i) {
+        FishVertex v = palette[shape[i].shade];
+        v.x = x + sx * shape[i].x;
+        v.y = y + sy * shape[i].y;
+        dst[i] = v;
+    }
+}
+
+void fishColor(bool isPlayer, bool isRedFish, const float speciesColor[3], float rgb[3]) {
+    if (isPlayer) {
+        rgb[0] = 0.2f; rgb[1] = 0.4f; rgb[2] = 1.0f;  // Blue player
+    } else if (isRedFish) {
+        rgb[0] = 1.0f; rgb[1] = 0.3f; rgb[2] = 0.3f;  // Red enemy
+    } else {
+        rgb[0] = speciesColor[0];                      // Yellow shade set by the level
+        rgb[1] = speciesColor[1];
+        rgb[2] = speciesColor[2];
+    }
+}
+
+FishLod fishLod(float scale, float pixelScale) {
+    float radius = BODY_RADIUS * scale * pixelScale;
+    if (radius >= FISH_LOD_FULL_RADIUS) return FISH_LOD_FULL;
+    if (radius >= FISH_LOD_MEDIUM_RADIUS) return FISH_LOD_MEDIUM;
+    if (radius >= FISH_LOD_SMALL_RADIUS) return FISH_LOD_SMALL;
+    return FISH_LOD_IMPOSTOR;
+}
+
+FishMesh::FishMesh() : culledFish(0) {
+    for (int lod = 0; lod < FISH_LOD_COUNT; ++lod) lodFish[lod] = 0;
+}
+
+void FishMesh::clear() {
+    fills.clear();
+    bodyLines.clear();
+    tailLines.clear();
+}
+
+void FishMesh::reserve(size_t fishCount) {
+    const FishTemplate& shape = fishTemplate(FISH_LOD_FULL);
+    fills.reserve(fishCount * shape.fills.size());
+    bodyLines.reserve(fishCount * shape.bodyLines.size());
+    tailLines.reserve(fishCount * shape.tailLines.size());
+}
+
+void FishMesh::addFish(float x, float y, float direction, float scale, const float color[3], FishLod lod) {
+    const FishTemplate& shape = fishTemplate(lod);
+    static const float shadeFactor[3] = {1.0f, 0.8f, 0.9f};
+
+    FishVertex palette[SHADE_COUNT];
+    for (int s = 0; s < 3; ++s) {
+        palette[s].r = toByte(color[0] * shadeFactor[s]);
+        palette[s].g = toByte(color[1] * shadeFactor[s]);
+        palette[s].b = toByte(color[2] * shadeFactor[s]);
+        palette[s].a = 255;
+    }
+    palette[SHADE_WHITE].r = palette[SHADE_WHITE].g = palette[SHADE_WHITE].b = 255;
+    palette[SHADE_WHITE].a = 255;
+    palette[SHADE_BLACK].r = palette[SHADE_BLACK].g = palette[SHADE_BLACK].b = 0;
+    palette[SHADE_BLACK].a = 255;
+
+    float dir = (direction < 0) ? -1.0f : 1.0f;
+    float sx = dir * scale;
+    appendShape(fills, shape.fills, x, y, sx, scale, palette);
+    appendShape(bodyLines, shape.bodyLines, x, y, sx, scale, palette);
+    appendShape(tailLines, shape.tailLines, x, y, sx, scale, palette);
+}
+
+void FishMesh::build(const WorldSnapshot& view, float pixelScale) {
+    clear();
+    for (int lod = 0; lod < FISH_LOD_COUNT; ++lod) lodFish[lod] = 0;
+
+    // Cull against the window as the camera sees the ocean, padded by how
+    // far a fish reaches from its centre
+    const float reach = BODY_LENGTH * 0.5f + TAIL_LENGTH;
+    const float left = view.cameraX, right = view.cameraX + WINDOW_WIDTH;
+    const float bottom = view.cameraY, top = view.cameraY + WINDOW_HEIGHT;
+    visible.clear();
+    for (size_t i = 0; i < view.fishCount(); ++i) {
+        float pad = reach * view.sizeScale[i];
+        if (view.x[i] + pad < left || view.x[i] - pad > right ||
+            view.y[i] + pad < bottom || view.y[i] - pad > top) {
+            continue;
+        }
+        visible.push_back(static_cast<int>(i));
+    }
+    culledFish = view.fishCount() - visible.size();
+
+    // Pick every level first so the arrays can be reserved exactly
+    FishLod playerLod = fishLod(view.playerSizeScale, pixelScale);
+    bool crowded = visible.size() > FISH_IMPOSTOR_COUNT;
+    visibleLod.resize(visible.size());
+    ++lodFish[playerLod];
+    for (size_t v = 0; v < visible.size(); ++v) {
+        FishLod lod = crowded ? FISH_LOD_IMPOSTOR : fishLod(view.sizeScale[visible[v]], pixelScale);
+        visibleLod[v] = static_cast<unsigned char>(lod);
+        ++lodFish[lod];
+    }
+    size_t fillCount = 0, bodyLineCount = 0, tailLineCount = 0;
+    for (int lod = 0; lod < FISH_LOD_COUNT; ++lod) {
+        const FishTemplate& shape = fishTemplate(static_cast<FishLod>(lod));
+        fillCount += lodFish[lod] * shape.fills.size();
+        bodyLineCount += lodFish[lod] * shape.bodyLines.size();
+        tailLineCount += lodFish[lod] * shape.tailLines.size();
+    }
+    fills.reserve(fillCount);
+    bodyLines.reserve(bodyLineCount);
+    tailLines.reserve(tailLineCount);
+
+    float rgb[3];
+    fishColor(true, false, view.speciesColor[0], rgb);
+    addFish(view.playerX, view.playerY, view.playerDirection, view.playerSizeScale, rgb, playerLod);
+
+    for (size_t v = 0; v < visible.size(); ++v) {
+        int i = visible[v];
+        fishColor(false, view.isRedFish[i] != 0, view.speciesColor[view.species[i]], rgb);
+        addFish(view.x[i], view.y[i], view.direction[i], view.sizeScale[i], rgb,
+                static_cast<FishLod>(visibleLod[v]));
+    }
+}
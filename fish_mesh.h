@@ -0,0 +1,87 @@
+//
+//  fish_mesh.h
+//  Fish-Fillet-Project
+//
+//  CPU-side fish geometry for the batched renderer. The fish outline is
+//  tessellated once into a unit template (scale 1, facing right); each frame
+//  every fish is a scaled, mirrored copy of it appended to flat vertex
+//  arrays. No trig and no GL calls happen per fish, so this also runs in
+//  headless builds and benchmarks.
+//
+//  There is one template per level of detail, picked per fish from its
+//  size on screen, and fish outside the view are skipped, so the vertex
+//  count follows what is visible rather than how many fish exist.
+//
+
+#ifndef FISH_MESH_H
+#define FISH_MESH_H
+
+#include "game_config.h"
+#include <cstddef>
+#include <vector>
+
+struct WorldSnapshot;
+
+// Interleaved vertex layout handed straight to glVertexPointer/glColorPointer
+struct FishVertex {
+    float x, y;
+    unsigned char r, g, b, a;
+};
+
+// Levels of detail, finest first
+enum FishLod {
+    FISH_LOD_FULL = 0,      // 20-segment body, 8-segment tail, fins, 12-segment eyes, outlines
+    FISH_LOD_MEDIUM = 1,    // 10-segment body, 4-segment tail, fins, 6-segment eyes, outlines
+    FISH_LOD_SMALL = 2,     // 6-segment body, 3-segment tail; no fins, eyes or outlines
+    FISH_LOD_IMPOSTOR = 3,  // One flat quad over the body and tail
+    FISH_LOD_COUNT = 4
+};
+
+// Projected body radius, in screen pixels, from which each level is used
+const float FISH_LOD_FULL_RADIUS = 16.0f;
+const float FISH_LOD_MEDIUM_RADIUS = 8.0f;
+const float FISH_LOD_SMALL_RADIUS = 4.0f;
+
+// Above this many visible fish, everything but the player is an impostor
+const size_t FISH_IMPOSTOR_COUNT = 5000;
+
+// Level for a fish of this size scale, at pixelScale screen pixels per unit
+FishLod fishLod(float scale, float pixelScale);
+
+class FishMesh {
+public:
+    std::vector<FishVertex> fills;      // GL_TRIANGLES: body, tail, fins, eyes
+    std::vector<FishVertex> bodyLines;  // GL_LINES: body outline (1.5 px)
+    std::vector<FishVertex> tailLines;  // GL_LINES: tail outline (1.0 px)
+
+    int lodFish[FISH_LOD_COUNT];  // Fish built at each level, last build
+    size_t culledFish;            // Fish outside the view, last build
+
+    FishMesh();
+
+    void clear();
+    void reserve(size_t fishCount);
+
+    // Append one fish; direction only matters for its sign
+    void addFish(float x, float y, float direction, float scale, const float color[3],
+                 FishLod lod = FISH_LOD_FULL);
+
+    // Player first, then every fish inside the view, in draw order
+    void build(const WorldSnapshot& view, float pixelScale = 1.0f);
+
+    size_t vertexCount() const {
+        return fills.size() + bodyLines.size() + tailLines.size();
+    }
+
+private:
+    std::vector<int> visible;             // Scratch: fish inside the view
+    std::vector<unsigned char> visibleLod;
+
+    FishMesh(const FishMesh&);
+    FishMesh& operator=(const FishMesh&);
+};
+
+// Base colour for a fish: blue player, red enemy, otherwise its species' colour
+void fishColor(bool isPlayer, bool isRedFish, const float speciesColor[3], float rgb[3]);
+
+#endif // FISH_MESH_H
@@ -0,0 +1,51 @@
+//
+//  fish_renderer.cpp
+//  Fish-Fillet-Project
+//
+
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/gl.h>
+#else
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/gl.h>
+#endif
+#include "fish_renderer.h"
+#include <algorithm>
+
+FishRenderer::FishRenderer() {
+    lastStats.drawCalls = 0;
+    lastStats.vertices = 0;
+}
+
+void FishRenderer::submit(const std::vector<FishVertex>& vertices, unsigned int mode, float lineWidth) {
+    if (vertices.empty()) return;
+    if (mode == GL_LINES) glLineWidth(lineWidth);
+    glVertexPointer(2, GL_FLOAT, sizeof(FishVertex), &vertices[0].x);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(FishVertex), &vertices[0].r);
+    glDrawArrays(mode, 0, static_cast<GLsizei>(vertices.size()));
+    ++lastStats.drawCalls;
+}
+
+void FishRenderer::draw(const WorldSnapshot& view) {
+    // Detail follows size in real pixels, so a small window draws less
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    float pixelScale = std::min(viewport[2] / static_cast<float>(WINDOW_WIDTH),
+                                viewport[3] / static_cast<float>(WINDOW_HEIGHT));
+    mesh.build(view, pixelScale);
+    lastStats.drawCalls = 0;
+    lastStats.vertices = mesh.vertexCount();
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    // Fills for every fish first, then outlines on top
+    submit(mesh.fills, GL_TRIANGLES, 1.0f);
+    submit(mesh.bodyLines, GL_LINES, 1.5f);
+    submit(mesh.tailLines, GL_LINES, 1.0f);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glLineWidth(1.0f);
+}
@@ -0,0 +1,39 @@
+//
+//  fish_renderer.h
+//  Fish-Fillet-Project
+//
+//  Draws every fish from one FishMesh with a handful of glDrawArrays calls.
+//  Uses GL 1.1 client-side vertex arrays, which every driver we target
+//  (including Mesa llvmpipe and the stock Windows opengl32) supports.
+//
+
+#ifndef FISH_RENDERER_H
+#define FISH_RENDERER_H
+
+#include "fish_mesh.h"
+
+struct RenderStats {
+    int drawCalls;   // glDrawArrays calls issued for fish last frame
+    size_t vertices; // Vertices submitted for fish last frame
+};
+
+class FishRenderer {
+public:
+    FishRenderer();
+
+    // Fish are in ocean coordinates; the caller moves the view to the camera
+    void draw(const WorldSnapshot& view);
+
+    const RenderStats& stats() const { return lastStats; }
+
+    // Fish per level of detail and fish culled, last frame
+    const FishMesh& lastMesh() const { return mesh; }
+
+private:
+    FishMesh mesh;
+    RenderStats lastStats;
+
+    void submit(const std::vector<FishVertex>& vertices, unsigned int mode, float lineWidth);
+};
+
+#endif // FISH_RENDERER_H
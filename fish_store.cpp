@@ -0,0 +1,114 @@
+//
+//  fish_store.cpp
+//  Fish-Fillet-Project
+//
+
+#include "fish_store.h"
+
+FishStore::FishStore() : slotCount(0), generationFloor(0), nextFloor(1) {}
+
+void FishStore::clear() {
+    // Slots are handed out from 0 again with a generation no old handle has,
+    // so every old reference goes stale without visiting them
+    slotCount = 0;
+    generationFloor = nextFloor++;
+    freeSlots.clear();
+    x.clear();
+    y.clear();
+    direction.clear();
+    sizeScale.clear();
+    isRedFish.clear();
+    species.clear();
+    id.clear();
+}
+
+void FishStore::reserve(size_t n) {
+    x.reserve(n);
+    y.reserve(n);
+    direction.reserve(n);
+    sizeScale.reserve(n);
+    isRedFish.reserve(n);
+    species.reserve(n);
+    id.reserve(n);
+    slotIndex.reserve(n);
+    slotGeneration.reserve(n);
+    freeSlots.reserve(n);
+}
+
+void FishStore::resize(size_t n) {
+    clear();
+    x.resize(n);
+    y.resize(n);
+    direction.resize(n);
+    sizeScale.resize(n);
+    isRedFish.resize(n);
+    species.resize(n);
+    id.resize(n);
+    if (slotIndex.size() < n) {
+        slotIndex.resize(n);
+        slotGeneration.resize(n);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        id[i] = static_cast<uint32_t>(i);
+        slotIndex[i] = static_cast<uint32_t>(i);
+        slotGeneration[i] = generationFloor;
+    }
+    slotCount = n;
+}
+
+FishHandle FishStore::push(const Fish& f) {
+    uint32_t slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(slotCount++);
+        if (slot == slotIndex.size()) {
+            slotIndex.push_back(0);
+            slotGeneration.push_back(0);
+        }
+        slotGeneration[slot] = generationFloor;
+    }
+    slotIndex[slot] = static_cast<uint32_t>(x.size());
+
+    x.push_back(f.x);
+    y.push_back(f.y);
+    direction.push_back(f.direction);
+    sizeScale.push_back(f.sizeScale);
+    isRedFish.push_back(f.isRedFish ? 1 : 0);
+    species.push_back(static_cast<unsigned char>(f.species));
+    id.push_back(slot);
+
+    FishHandle h = {slot, slotGeneration[slot]};
+    return h;
+}
+
+void FishStore::remove(size_t i) {
+    uint32_t slot = id[i];
+    if (++slotGeneration[slot] >= nextFloor) nextFloor = slotGeneration[slot] + 1;
+    freeSlots.push_back(slot);
+
+    size_t last = x.size() - 1;
+    if (i != last) {
+        x[i] = x[last];
+        y[i] = y[last];
+        direction[i] = direction[last];
+        sizeScale[i] = sizeScale[last];
+        isRedFish[i] = isRedFish[last];
+        species[i] = species[last];
+        id[i] = id[last];
+        slotIndex[id[i]] = static_cast<uint32_t>(i);
+    }
+    x.pop_back();
+    y.pop_back();
+    direction.pop_back();
+    sizeScale.pop_back();
+    isRedFish.pop_back();
+    species.pop_back();
+    id.pop_back();
+}
+
+Fish FishStore::get(size_t i) const {
+    return Fish(x[i], y[i], direction[i], sizeScale[i], isRedFish[i] != 0,
+                species[i]);
+}
@@ -0,0 +1,91 @@
+//
+//  fish_store.h
+//  Fish-Fillet-Project
+//
+//  Structure-of-arrays storage for the non-player fish. Each field lives in
+//  its own contiguous array so the behavior kernel can stream through them
+//  with SIMD loads instead of hopping across Fish objects.
+//
+//  Live fish are always packed into [0, size()). Removing one moves the last
+//  fish into the hole (swap-and-pop), so removal is O(1) but does not keep
+//  order. Code that needs to refer to a particular fish across removals
+//  holds a FishHandle; the generation check makes handles to removed fish
+//  fail instead of silently pointing at whoever reused the slot.
+//
+//  Storage only grows: clear() keeps every array's capacity and retires all
+//  handles at once by raising the generation floor, so a restart is O(1)
+//  and respawning into a store that has held as many fish never allocates.
+//  Slots freed by removed fish are handed out again first.
+//
+
+#ifndef FISH_STORE_H
+#define FISH_STORE_H
+
+#include "fish.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct FishHandle {
+    uint32_t id;          // Stable slot in the handle table
+    uint32_t generation;  // Bumped every time the slot is freed
+};
+
+class FishStore {
+public:
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> direction;
+    std::vector<float> sizeScale;
+    std::vector<unsigned char> isRedFish;
+    std::vector<unsigned char> species;    // Index into the level's species table
+    std::vector<uint32_t> id;             // Handle slot owning each packed fish
+
+    // Number of live fish; maintained by push/remove, so O(1)
+    size_t size() const { return x.size(); }
+    bool empty() const { return x.empty(); }
+
+    void clear();
+    void reserve(size_t n);
+    FishHandle push(const Fish& f);
+
+    // Clear, then make room for n fish in slots 0..n-1 for the caller to
+    // fill in array by array (restoring a WorldState)
+    void resize(size_t n);
+
+    // Swap-and-pop fish i; the fish that was last now lives at i
+    void remove(size_t i);
+
+    // Packed index of a live fish, or -1 if the handle is stale
+    long indexOf(FishHandle h) const {
+        if (h.id >= slotCount || slotGeneration[h.id] != h.generation) return -1;
+        return static_cast<long>(slotIndex[h.id]);
+    }
+    bool alive(FishHandle h) const { return indexOf(h) >= 0; }
+    FishHandle handle(size_t i) const {
+        FishHandle h = {id[i], slotGeneration[id[i]]};
+        return h;
+    }
+
+    float collisionRadius(size_t i) const {
+        return COLLISION_RADIUS * sizeScale[i];
+    }
+
+    // Materialize fish i as an object (rendering and debugging)
+    Fish get(size_t i) const;
+
+    // Fish the arrays hold without reallocating
+    size_t capacity() const { return x.capacity(); }
+
+    FishStore();
+
+private:
+    std::vector<uint32_t> slotIndex;       // Handle slot -> packed index
+    std::vector<uint32_t> slotGeneration;  // Handle slot -> current generation
+    std::vector<uint32_t> freeSlots;       // Handle slots ready for reuse
+    size_t slotCount;                      // Slots handed out since the last clear
+    uint32_t generationFloor;              // Generation of slots first used since the last clear
+    uint32_t nextFloor;                    // Above every generation handed out so far
+};
+
+#endif // FISH_STORE_H
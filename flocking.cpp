@@ -0,0 +1,157 @@
+//
+//  flocking.cpp
+//  Fish-Fillet-Project
+//
+
+#include "flocking.h"
+#include "job_system.h"
+#include <algorithm>
+#include <cmath>
+
+float flockCellSize(size_t fishCount, float area) {
+    float size = std::sqrt(area * FLOCK_FISH_PER_CELL / std::max<size_t>(fishCount, 1));
+    return std::min(std::max(size, 8.0f), SPATIAL_CELL_SIZE);
+}
+
+void NeighborCache::resize(size_t count) {
+    indices.resize(count * MAX_NEIGHBORS);
+    distances2.resize(count * MAX_NEIGHBORS);
+    counts.resize(count);
+}
+
+void NeighborCache::build(const FishStore& fish, const SpatialHash& grid, float radius,
+                          size_t begin, size_t end) {
+    const float cellArea = grid.cellSize() * grid.cellSize();
+    for (size_t i = begin; i < end; ++i) {
+        // Estimate the local density from this fish's cell and shrink the
+        // view until about NEIGHBOR_CANDIDATES fish are expected in it
+        float view = radius;
+        int crowd = grid.cellPopulation(fish.x[i], fish.y[i]);
+        float crowdView2 = NEIGHBOR_CANDIDATES * cellArea / (PI * crowd);
+        if (crowdView2 < view * view) view = std::sqrt(crowdView2);
+
+        int* best = &indices[i * MAX_NEIGHBORS];
+        float* bestD2 = &distances2[i * MAX_NEIGHBORS];
+        int n = 0;
+        int self = static_cast<int>(i);
+
+        // Insertion into a short sorted list; anything farther than a full
+        // list's last entry is skipped without touching it
+        grid.forEachNear(fish.x[i], fish.y[i], view, [&](int j, float d2) {
+            if (j == self) return;
+            if (n == MAX_NEIGHBORS &&
+                (d2 > bestD2[n - 1] || (d2 == bestD2[n - 1] && j > best[n - 1]))) return;
+            int slot = n < MAX_NEIGHBORS ? n++ : MAX_NEIGHBORS - 1;
+            while (slot > 0 && (bestD2[slot - 1] > d2 || (bestD2[slot - 1] == d2 && best[slot - 1] > j))) {
+                best[slot] = best[slot - 1];
+                bestD2[slot] = bestD2[slot - 1];
+                --slot;
+            }
+            best[slot] = j;
+            bestD2[slot] = d2;
+        });
+        counts[i] = static_cast<unsigned char>(n);
+    }
+}
+
+void steerFlock(const FishStore& fish, const NeighborCache& cache, const BehaviorParams& params,
+                float* driftX, float* driftY, size_t begin, size_t end) {
+    const float* xs = fish.x.data();
+    const float* ys = fish.y.data();
+    const float* dirs = fish.direction.data();
+    const unsigned char* species = fish.species.data();
+    const bool hunting = params.huntSpeed > 0.0f;
+    const float separation2 = params.separationRadius * params.separationRadius;
+
+    for (size_t i = begin; i < end; ++i) {
+        const int* near = cache.neighbors(i);
+        int count = cache.count(i);
+        int kind = species[i];
+
+        int threat = -1, prey = -1;
+        int mates = 0;
+        float sepX = 0.0f, sepY = 0.0f;
+        float headingSum = 0.0f;
+        float offsetX = 0.0f, offsetY = 0.0f;
+
+        // Neighbors come nearest first, so the first threat or prey found
+        // is the closest one
+        for (int k = 0; k < count; ++k) {
+            int j = near[k];
+            float dx = xs[j] - xs[i];
+            float dy = ys[j] - ys[i];
+            if (hunting) {
+                if (threat < 0 && canHunt(fish, params, j, i)) threat = j;
+                if (prey < 0 && canHunt(fish, params, i, j)) prey = j;
+            }
+            if (species[j] != kind) continue;
+
+            ++mates;
+            headingSum += dirs[j];
+            offsetX += dx;
+            offsetY += dy;
+            float d2 = dx * dx + dy * dy;
+            if (d2 < separation2 && d2 > 0.0f) {
+                // Push away harder the closer a schoolmate is
+                float d = std::sqrt(d2);
+                float push = 1.0f - d / params.separationRadius;
+                sepX -= dx / d * push;
+                sepY -= dy / d * push;
+            }
+        }
+
+        float stepX = dirs[i];
+        float stepY = 0.0f;
+        if (threat >= 0 || prey >= 0) {
+            int other = threat >= 0 ? threat : prey;
+            float dx = xs[other] - xs[i];
+            float dy = ys[other] - ys[i];
+            float norm = std::sqrt(dx * dx + dy * dy) + 0.001f;
+            float speed = threat >= 0 ? -params.huntSpeed : params.huntSpeed;
+            stepX = dx / norm * speed;
+            stepY = dy / norm * speed;
+        } else if (mates > 0) {
+            // Each term is about unit size: separation is already, heading
+            // difference is in fish speeds and the offset to the school's
+            // centre is in neighbor radii
+            float inv = 1.0f / mates;
+            float alignX = (headingSum * inv - dirs[i]) / FISH_SPEED;
+            float cohereX = offsetX * inv / params.neighborRadius;
+            float cohereY = offsetY * inv / params.neighborRadius;
+            float vx = FISH_SPEED * (params.separation[kind] * sepX + params.alignment[kind] * alignX +
+                                     params.cohesion[kind] * cohereX);
+            float vy = FISH_SPEED * (params.separation[kind] * sepY + params.cohesion[kind] * cohereY);
+            float speed2 = vx * vx + vy * vy;
+            if (speed2 > params.schoolSpeed * params.schoolSpeed) {
+                float scale = params.schoolSpeed / std::sqrt(speed2);
+                vx *= scale;
+                vy *= scale;
+            }
+            stepX += vx;
+            stepY = vy;
+        }
+        driftX[i] = stepX;
+        driftY[i] = stepY;
+    }
+}
+
+void updateFlock(const FishStore& fish, const SpatialHash& grid, const BehaviorParams& params,
+                 NeighborCache& cache, std::vector<float>& driftX, std::vector<float>& driftY,
+                 JobSystem* jobs) {
+    size_t count = fish.size();
+    cache.resize(count);
+    driftX.resize(count);
+    driftY.resize(count);
+
+    // A fish's steering only needs its own neighbor list, so one pass per
+    // chunk builds the lists and steers
+    auto flockChunk = [&](size_t, size_t begin, size_t end) {
+        cache.build(fish, grid, params.neighborRadius, begin, end);
+        steerFlock(fish, cache, params, driftX.data(), driftY.data(), begin, end);
+    };
+    if (jobs && jobs->threadCount() > 1 && count >= PARALLEL_FLOCK_MIN_FISH) {
+        jobs->parallelFor(count, FLOCK_CHUNK_SIZE, flockChunk);
+    } else {
+        flockChunk(0, 0, count);
+    }
+}
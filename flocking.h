@@ -0,0 +1,78 @@
+//
+//  flocking.h
+//  Fish-Fillet-Project
+//
+//  Fish-to-fish behavior: boids-style schooling (separation, alignment,
+//  cohesion) between fish of the same species, and hunting, where red and
+//  chasing species go after fish smaller than themselves and those fish
+//  flee. Both read a neighbor cache built once per tick from a spatial
+//  hash whose cells shrink as the ocean fills up. Each fish keeps at most
+//  MAX_NEIGHBORS of its nearest fish, and in a crowd it only looks as far
+//  as it takes to expect NEIGHBOR_CANDIDATES fish, so the work per fish
+//  stays about the same however crowded the ocean gets.
+//
+//  The result is a drift velocity per fish that the behavior kernel uses in
+//  place of plain `direction` drift. Reacting to the player still overrides
+//  it, as before.
+//
+
+#ifndef FLOCKING_H
+#define FLOCKING_H
+
+#include "fish_store.h"
+#include "level.h"
+#include "spatial_hash.h"
+#include <vector>
+
+class JobSystem;
+
+const int MAX_NEIGHBORS = 8;                // Nearest fish each fish reacts to
+const int NEIGHBOR_CANDIDATES = 24;         // Fish a crowded fish expects to look at
+const float FLOCK_FISH_PER_CELL = 4.0f;     // Target load of the flocking grid
+const size_t PARALLEL_FLOCK_MIN_FISH = 4096;
+const size_t FLOCK_CHUNK_SIZE = 1024;
+
+// Cell size for a flocking grid over fishCount fish spread over area: about
+// FLOCK_FISH_PER_CELL fish per cell, never coarser than the collision grid
+float flockCellSize(size_t fishCount, float area = static_cast<float>(WINDOW_WIDTH) * OCEAN_HEIGHT);
+
+class NeighborCache {
+public:
+    void resize(size_t count);
+
+    // For fish [begin, end): up to MAX_NEIGHBORS nearest other fish within
+    // radius (less in a crowd), nearest first, ties broken by index. grid
+    // must hold the store's current positions.
+    void build(const FishStore& fish, const SpatialHash& grid, float radius, size_t begin, size_t end);
+
+    int count(size_t i) const { return counts[i]; }
+    const int* neighbors(size_t i) const { return &indices[i * MAX_NEIGHBORS]; }
+
+private:
+    std::vector<int> indices;           // MAX_NEIGHBORS slots per fish
+    std::vector<float> distances2;      // Matching squared distances
+    std::vector<unsigned char> counts;
+};
+
+// Whether fish `hunter` chases and can eat fish `prey`: the hunter is red or
+// of a chasing species, and the prey is clearly smaller, the same test a
+// chasing fish applies to the player
+inline bool canHunt(const FishStore& fish, const BehaviorParams& params, size_t hunter, size_t prey) {
+    return (fish.isRedFish[hunter] || params.chases[fish.species[hunter]]) &&
+           fish.collisionRadius(prey) < fish.collisionRadius(hunter) * 0.95f;
+}
+
+// Drift for fish [begin, end) from their cached neighbors. Fleeing a hunter
+// comes first, then chasing prey, then schooling; a fish with none of
+// those keeps drifting at (direction, 0).
+void steerFlock(const FishStore& fish, const NeighborCache& cache, const BehaviorParams& params,
+                float* driftX, float* driftY, size_t begin, size_t end);
+
+// Rebuild the neighbor cache and every fish's drift. Each fish only writes
+// its own entries, so large oceans are split over jobs with identical
+// results.
+void updateFlock(const FishStore& fish, const SpatialHash& grid, const BehaviorParams& params,
+                 NeighborCache& cache, std::vector<float>& driftX, std::vector<float>& driftY,
+                 JobSystem* jobs = 0);
+
+#endif // FLOCKING_H
@@ -0,0 +1,154 @@
+//
+//  frame_scheduler.cpp
+//  Fish-Fillet-Project
+//
+
+#include "frame_scheduler.h"
+#include <cmath>
+#include <thread>
+
+typedef std::chrono::duration<double, std::milli> Milliseconds;
+
+// Sleeps overshoot by up to a scheduler quantum; spin through the last bit
+static const FrameScheduler::Clock::duration SPIN_WINDOW = std::chrono::microseconds(1000);
+
+FrameStats::FrameStats()
+    : frames(0), intervals(0), skipped(0), sumMs(0.0), sumSquaresMs(0.0), maxMs(0.0), sumJitterMs(0.0) {
+    for (int b = 0; b <= FRAME_HISTOGRAM_BUCKETS; ++b) histogram[b] = 0;
+}
+
+double FrameStats::averageMs() const {
+    return intervals > 0 ? sumMs / intervals : 0.0;
+}
+
+double FrameStats::stddevMs() const {
+    if (intervals < 2) return 0.0;
+    double mean = averageMs();
+    double variance = sumSquaresMs / intervals - mean * mean;
+    return variance > 0.0 ? std::sqrt(variance) : 0.0;
+}
+
+double FrameStats::averageJitterMs() const {
+    return intervals > 0 ? sumJitterMs / intervals : 0.0;
+}
+
+double FrameStats::percentileMs(double p) const {
+    if (intervals == 0) return 0.0;
+    long rank = static_cast<long>(std::ceil(p * intervals));
+    if (rank < 1) rank = 1;
+    long seen = 0;
+    for (int b = 0; b < FRAME_HISTOGRAM_BUCKETS; ++b) {
+        seen += histogram[b];
+        if (seen >= rank) return (b + 1) * FRAME_HISTOGRAM_BUCKET_MS;
+    }
+    return maxMs;  // In the overflow bucket
+}
+
+FrameScheduler::FrameScheduler(int hz) : started(false) {
+    setTargetRate(hz);
+}
+
+void FrameScheduler::setTargetRate(int hz) {
+    targetHz = hz > 0 ? hz : FRAME_RATE_UNLOCKED;
+    if (targetHz == FRAME_RATE_UNLOCKED) {
+        period = Clock::duration::zero();
+    } else {
+        period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / targetHz));
+    }
+    // Pace from the next frame on; the old deadlines mean nothing now
+    if (started) nextDue = lastFrame + period;
+    resetStats();
+}
+
+double FrameScheduler::periodMs() const {
+    return Milliseconds(period).count();
+}
+
+FrameScheduler::Clock::duration FrameScheduler::untilDue(Clock::time_point now) const {
+    if (!started || period == Clock::duration::zero()) return Clock::duration::zero();
+    return nextDue - now;
+}
+
+bool FrameScheduler::waitForFrame(Clock::duration maxWait) {
+    Clock::time_point now = Clock::now();
+    Clock::duration wait = untilDue(now);
+    if (wait <= Clock::duration::zero()) return true;
+    if (wait > SPIN_WINDOW) {
+        Clock::duration sleep = wait - SPIN_WINDOW;
+        std::this_thread::sleep_for(sleep < maxWait ? sleep : maxWait);
+        return untilDue(Clock::now()) <= Clock::duration::zero();
+    }
+    while (untilDue(Clock::now()) > Clock::duration::zero()) {
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+void FrameScheduler::beginFrame(Clock::time_point now) {
+    if (!started) {
+        started = true;
+        firstFrame = now;
+        nextDue = now;
+    } else {
+        double intervalMs = Milliseconds(now - lastFrame).count();
+        int bucket = static_cast<int>(intervalMs / FRAME_HISTOGRAM_BUCKET_MS);
+        if (bucket > FRAME_HISTOGRAM_BUCKETS || bucket < 0) bucket = FRAME_HISTOGRAM_BUCKETS;
+        ++frameStats.histogram[bucket];
+        ++frameStats.intervals;
+        frameStats.sumMs += intervalMs;
+        frameStats.sumSquaresMs += intervalMs * intervalMs;
+        if (intervalMs > frameStats.maxMs) frameStats.maxMs = intervalMs;
+        if (period != Clock::duration::zero()) frameStats.sumJitterMs += std::fabs(intervalMs - periodMs());
+    }
+    ++frameStats.frames;
+    lastFrame = now;
+    if (period == Clock::duration::zero()) return;
+
+    // Next deadline on the original grid. A whole period or more behind,
+    // drop the missed deadlines instead of rendering them back to back.
+    nextDue += period;
+    if (now - nextDue >= period) {
+        long behind = static_cast<long>((now - nextDue) / period);
+        frameStats.skipped += behind;
+        nextDue += period * behind;
+    }
+}
+
+double FrameScheduler::elapsedSeconds(Clock::time_point now) const {
+    if (!started) return 0.0;
+    return std::chrono::duration<double>(now - firstFrame).count();
+}
+
+void FrameScheduler::resetStats() {
+    frameStats = FrameStats();
+}
+
+void FrameScheduler::report(FILE* out) const {
+    const FrameStats& s = frameStats;
+    if (targetHz == FRAME_RATE_UNLOCKED) {
+        std::fprintf(out, "frame pacing: unlocked  frames %ld\n", s.frames);
+    } else {
+        std::fprintf(out, "frame pacing: target %d Hz (%.3f ms)  frames %ld  skipped %ld\n", targetHz, periodMs(),
+                     s.frames, s.skipped);
+    }
+    std::fprintf(out, "interval avg %.3f ms  stddev %.3f  p50 %.2f  p99 %.2f  max %.3f  mean |jitter| %.3f ms\n",
+                 s.averageMs(), s.stddevMs(), s.percentileMs(0.5), s.percentileMs(0.99), s.maxMs,
+                 s.averageJitterMs());
+
+    long tallest = 0;
+    for (int b = 0; b <= FRAME_HISTOGRAM_BUCKETS; ++b) {
+        if (s.histogram[b] > tallest) tallest = s.histogram[b];
+    }
+    for (int b = 0; b <= FRAME_HISTOGRAM_BUCKETS; ++b) {
+        if (s.histogram[b] == 0) continue;
+        int bar = static_cast<int>(50 * s.histogram[b] / tallest);
+        if (bar == 0) bar = 1;
+        if (b == FRAME_HISTOGRAM_BUCKETS) {
+            std::fprintf(out, "  %6.2f+       ms  ", b * FRAME_HISTOGRAM_BUCKET_MS);
+        } else {
+            std::fprintf(out, "  %6.2f-%6.2f ms  ", b * FRAME_HISTOGRAM_BUCKET_MS, (b + 1) * FRAME_HISTOGRAM_BUCKET_MS);
+        }
+        for (int i = 0; i < bar; ++i) std::fputc('#', out);
+        std::fprintf(out, " %ld\n", s.histogram[b]);
+    }
+}
@@ -0,0 +1,89 @@
+//
+//  frame_scheduler.h
+//  Fish-Fillet-Project
+//
+//  Paces rendering to a target rate (30, 60, 120 Hz, or unlocked) on the
+//  monotonic clock. Deadlines advance by exact periods from the first
+//  frame, so timer rounding never accumulates into drift. When rendering
+//  falls a whole period behind, the missed frames are skipped rather than
+//  drawn late in a burst; the simulation has its own thread and carries on
+//  regardless.
+//
+//  Every frame's start-to-start interval goes into a histogram, so pacing
+//  quality (spread, jitter against the target, long frames) can be shown
+//  rather than guessed. Nothing here touches GL, so offscreen runs can be
+//  paced and measured too.
+//
+
+#ifndef FRAME_SCHEDULER_H
+#define FRAME_SCHEDULER_H
+
+#include <chrono>
+#include <cstdio>
+
+const int FRAME_RATE_UNLOCKED = 0;
+const int FRAME_HISTOGRAM_BUCKETS = 200;       // Plus one for anything longer
+const double FRAME_HISTOGRAM_BUCKET_MS = 0.25; // So the histogram covers 0-50 ms
+
+struct FrameStats {
+    long frames;        // Frames begun
+    long intervals;     // Start-to-start intervals measured (frames - 1)
+    long skipped;       // Deadlines dropped because rendering fell behind
+    double sumMs;       // Of intervals
+    double sumSquaresMs;
+    double maxMs;
+    double sumJitterMs; // Of |interval - target period|; 0 while unlocked
+    long histogram[FRAME_HISTOGRAM_BUCKETS + 1];
+
+    FrameStats();
+
+    double averageMs() const;
+    double stddevMs() const;
+    double averageJitterMs() const;
+
+    // Upper edge of the bucket holding the p-th percentile interval (p in 0-1)
+    double percentileMs(double p) const;
+};
+
+class FrameScheduler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    explicit FrameScheduler(int targetHz = 60);
+
+    // Frames per second to aim for; FRAME_RATE_UNLOCKED draws as often as possible
+    void setTargetRate(int hz);
+    int targetRate() const { return targetHz; }
+    double periodMs() const;
+
+    // Time left until the next frame is due; zero or negative once it is
+    Clock::duration untilDue(Clock::time_point now) const;
+
+    // Sleep toward the next deadline, but never longer than maxWait, so the
+    // caller can keep handling input; the last stretch is spun for accuracy.
+    // True once the frame is due.
+    bool waitForFrame(Clock::duration maxWait);
+
+    // Start of a rendered frame: record its interval and set the next deadline
+    void beginFrame(Clock::time_point now);
+
+    // Seconds since the first frame, for time-driven animation
+    double elapsedSeconds(Clock::time_point now) const;
+
+    const FrameStats& stats() const { return frameStats; }
+    void resetStats();
+
+    // Summary line plus a text histogram of the non-empty buckets
+    void report(FILE* out) const;
+
+private:
+    int targetHz;
+    Clock::duration period;       // Zero when unlocked
+    bool started;
+    Clock::time_point firstFrame;
+    Clock::time_point lastFrame;
+    Clock::time_point nextDue;
+    FrameStats frameStats;
+};
+
+#endif // FRAME_SCHEDULER_H
@@ -0,0 +1,51 @@
+//
+//  game_config.h
+//  Fish-Fillet-Project
+//
+//  Gameplay constants shared by the simulation and the renderer.
+//
+
+#ifndef GAME_CONFIG_H
+#define GAME_CONFIG_H
+
+// Game Constants
+const int WINDOW_WIDTH = 1200;
+const int WINDOW_HEIGHT = 600;
+const int OCEAN_HEIGHT = 500;
+const int NUM_FISH = 20;
+const int INITIAL_TIME = 20;
+const float FISH_SIZE = 20.0f;
+const float COLLISION_RADIUS = 15.0f;
+const float FISH_SPEED = 0.4f;
+const float PI = 3.1415926f;
+
+// Behavior tuning
+const float SAFE_SPAWN_DISTANCE = 150.0f;   // Minimum distance from player when spawning fish
+const float FLEE_DISTANCE = 220.0f;         // Distance at which smaller fish start fleeing
+const float CHASE_DISTANCE = 260.0f;        // Distance at which bigger/red fish start chasing
+const float FLEE_SPEED_MULT = 1.8f;         // Speed multiplier for fleeing fish
+const float CHASE_SPEED_MULT = 1.4f;        // Speed multiplier for chasing fish
+
+// Fish size types
+enum FishSizeType {
+    SMALL = 0,    // 0.8x size
+    MEDIUM = 1,   // 1.0x size
+    LARGE = 2     // 1.5x size
+};
+
+const float SIZE_MULTIPLIERS[] = {0.8f, 1.0f, 1.5f};
+const float GROWTH_INCREMENT = 0.05f;  // Player grows by this amount per fish eaten
+const float INITIAL_PLAYER_SIZE = 1.0f;
+const float MAX_PLAYER_SIZE = 2.5f;
+
+// Scrolling worlds (levels bigger than the window)
+const float CAMERA_EDGE_X = 300.0f;    // Mouse this close to the left or right scrolls the view
+const float CAMERA_EDGE_Y = 120.0f;    // Likewise for the seabed and the surface
+const float CAMERA_SPEED = 12.0f;      // Pixels per tick with the mouse at the very edge
+
+// Simulation timing
+const float SIM_DT = 0.02f;            // Fixed simulation step (the old 20 ms animation timer)
+const int TICKS_PER_SECOND = 50;       // Ticks per game-clock second
+const int MAX_STEPS_PER_FRAME = 10;    // Cap catch-up after a stall so we never spiral
+
+#endif // GAME_CONFIG_H
@@ -0,0 +1,198 @@
+//
+//  input_record.cpp
+//  Fish-Fillet-Project
+//
+
+#include "input_record.h"
+#include "world.h"
+#include "world_state.h"
+#include <cstring>
+
+static const char RECORD_MAGIC[8] = {'F', 'I', 'S', 'H', 'R', 'E', 'C', '1'};
+
+static void putVarint(std::FILE* f, uint64_t v) {
+    while (v >= 0x80) {
+        std::fputc(static_cast<int>((v & 0x7F) | 0x80), f);
+        v >>= 7;
+    }
+    std::fputc(static_cast<int>(v), f);
+}
+
+static void putLE(std::FILE* f, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        std::fputc(static_cast<int>((v >> (8 * i)) & 0xFF), f);
+    }
+}
+
+InputRecorder::InputRecorder() : file(0), lastTick(0) {}
+
+InputRecorder::~InputRecorder() {
+    if (file) std::fclose(file);
+}
+
+bool InputRecorder::open(const char* path, uint64_t masterSeed) {
+    file = std::fopen(path, "wb");
+    if (!file) return false;
+    std::fwrite(RECORD_MAGIC, 1, sizeof(RECORD_MAGIC), file);
+    putLE(file, masterSeed, 8);
+    lastTick = 0;
+    return true;
+}
+
+void InputRecorder::writeHeader(uint8_t type, long tick) {
+    std::fputc(type, file);
+    putVarint(file, static_cast<uint64_t>(tick - lastTick));
+    lastTick = tick;
+}
+
+void InputRecorder::mouse(long tick, int x, int y) {
+    if (!file) return;
+    writeHeader(INPUT_MOUSE, tick);
+    putLE(file, static_cast<uint16_t>(static_cast<int16_t>(x)), 2);
+    putLE(file, static_cast<uint16_t>(static_cast<int16_t>(y)), 2);
+}
+
+void InputRecorder::key(long tick, int key) {
+    if (!file) return;
+    writeHeader(INPUT_KEY, tick);
+    putLE(file, static_cast<uint16_t>(key), 2);
+    if (key == INPUT_KEY_RESTART) lastTick = 0;
+    std::fflush(file);  // Rounds are the unit people report; don't lose one
+}
+
+void InputRecorder::seek(long tick) {
+    if (!file) return;
+    std::fputc(INPUT_SEEK, file);
+    putVarint(file, static_cast<uint64_t>(tick));
+    lastTick = tick;
+    std::fflush(file);
+}
+
+void InputRecorder::close(long tick) {
+    if (!file) return;
+    writeHeader(INPUT_END, tick);
+    std::fclose(file);
+    file = 0;
+}
+
+// Reader over the whole file in memory
+struct RecordReader {
+    const std::vector<unsigned char>& data;
+    size_t pos;
+    bool ok;
+
+    explicit RecordReader(const std::vector<unsigned char>& d) : data(d), pos(0), ok(true) {}
+
+    uint64_t le(int bytes) {
+        if (pos + bytes > data.size()) { ok = false; return 0; }
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= static_cast<uint64_t>(data[pos + i]) << (8 * i);
+        pos += bytes;
+        return v;
+    }
+
+    uint64_t varint() {
+        uint64_t v = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            if (pos >= data.size()) break;
+            unsigned char b = data[pos++];
+            v |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+};
+
+bool InputReplay::load(const char* path) {
+    events.clear();
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        lastError = std::string("cannot open ") + path;
+        return false;
+    }
+    std::vector<unsigned char> data;
+    unsigned char buffer[4096];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), f)) > 0) {
+        data.insert(data.end(), buffer, buffer + n);
+    }
+    std::fclose(f);
+
+    if (data.size() < sizeof(RECORD_MAGIC) + 8 ||
+        std::memcmp(&data[0], RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0) {
+        lastError = "not a fish input recording";
+        return false;
+    }
+
+    RecordReader in(data);
+    in.pos = sizeof(RECORD_MAGIC);
+    masterSeed = in.le(8);
+
+    long tick = 0;
+    while (in.ok && in.pos < data.size()) {
+        InputEvent e;
+        e.type = data[in.pos++];
+        uint64_t ticks = in.varint();
+        if (e.type == INPUT_SEEK) {
+            tick = static_cast<long>(ticks);
+            continue;
+        }
+        tick += static_cast<long>(ticks);
+        e.tick = tick;
+        e.x = e.y = 0;
+        if (e.type == INPUT_MOUSE) {
+            e.x = static_cast<int16_t>(in.le(2));
+            e.y = static_cast<int16_t>(in.le(2));
+        } else if (e.type == INPUT_KEY) {
+            e.x = static_cast<int>(in.le(2));
+            if (e.x == INPUT_KEY_RESTART) tick = 0;
+        } else if (e.type != INPUT_END) {
+            in.ok = false;
+            break;
+        }
+        if (!in.ok) break;
+        events.push_back(e);
+        if (e.type == INPUT_END) break;
+    }
+
+    if (!in.ok || events.empty() || events.back().type != INPUT_END) {
+        lastError = "recording is truncated or corrupt";
+        return false;
+    }
+    return true;
+}
+
+void applyInput(World& world, const InputEvent& event, StateHistory* history) {
+    if (event.type == INPUT_MOUSE) {
+        world.mouseMove(static_cast<float>(event.x), static_cast<float>(event.y));
+    } else if (event.type == INPUT_KEY && event.x == INPUT_KEY_RESTART) {
+        world.reset();
+    } else if (event.type == INPUT_KEY && history) {
+        std::string error;
+        if (event.x == INPUT_KEY_SAVE_STATE) history->save(world);
+        if (event.x == INPUT_KEY_LOAD_STATE) history->load(world, error);  // Nothing saved yet, or other rules
+        if (event.x == INPUT_KEY_REWIND) history->rewind(world);
+    }
+}
+
+long replayInput(World& world, const InputReplay& replay) {
+    JobSystem* jobs = world.jobs;
+    std::shared_ptr<const Level> level = world.level;
+    world = World(replay.masterSeed);
+    world.jobs = jobs;
+    if (level != world.level) world.setLevel(level);
+    StateHistory history;
+    long ticks = 0;
+    for (size_t i = 0; i < replay.events.size(); ++i) {
+        const InputEvent& e = replay.events[i];
+        while (world.tickCount < e.tick) {
+            world.tick();
+            history.afterTick(world);
+            ++ticks;
+        }
+        world.events.clear();
+        applyInput(world, e, &history);
+    }
+    return ticks;
+}
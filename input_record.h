@@ -0,0 +1,106 @@
+//
+//  input_record.h
+//  Fish-Fillet-Project
+//
+//  Compact binary recording of player input against simulation ticks.
+//  Together with the master seed in the header this reproduces a session
+//  exactly, and replay needs no window, so it runs as fast as the
+//  simulation can tick.
+//
+//  File layout (little-endian):
+//    "FISHREC1"        8-byte magic and version
+//    u64 masterSeed    seed handed to World::seedRounds
+//    records...        u8 type, varint tick delta, payload
+//      INPUT_MOUSE     i16 x, i16 y      window coordinates from GLUT
+//      INPUT_KEY       u16 key           GLUT special key code
+//      INPUT_END       (none)            tick at which recording stopped
+//      INPUT_SEEK      (none)            the varint is the new absolute tick
+//  Tick deltas are relative to the previous record; a restart key press
+//  resets the base to zero along with World::tickCount. Loading or
+//  rewinding a save state (world_state.h) moves the world to another tick,
+//  which the recorder notes with an INPUT_SEEK after the key.
+//
+
+#ifndef INPUT_RECORD_H
+#define INPUT_RECORD_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class StateHistory;
+class World;
+
+enum InputType {
+    INPUT_MOUSE = 1,
+    INPUT_KEY = 2,
+    INPUT_END = 3,
+    INPUT_SEEK = 4
+};
+
+const int INPUT_KEY_RESTART = 0x0002;     // GLUT_KEY_F2
+const int INPUT_KEY_SAVE_STATE = 0x0005;  // GLUT_KEY_F5, quick save
+const int INPUT_KEY_LOAD_STATE = 0x0006;  // GLUT_KEY_F6, quick load
+const int INPUT_KEY_REWIND = 0x0007;      // GLUT_KEY_F7, back about a second
+
+// Keys that can move the world to another tick
+inline bool jumpsInTime(int key) {
+    return key == INPUT_KEY_LOAD_STATE || key == INPUT_KEY_REWIND;
+}
+
+struct InputEvent {
+    uint8_t type;
+    long tick;   // World::tickCount when the event arrived
+    int x, y;    // Mouse position, or key code in x
+};
+
+class InputRecorder {
+public:
+    InputRecorder();
+    ~InputRecorder();
+
+    bool open(const char* path, uint64_t masterSeed);
+    bool isOpen() const { return file != 0; }
+
+    void mouse(long tick, int x, int y);
+    void key(long tick, int key);
+
+    // The world now stands at this tick (after a state load or rewind)
+    void seek(long tick);
+
+    // Write the end marker and close the file
+    void close(long tick);
+
+private:
+    std::FILE* file;
+    long lastTick;
+
+    void writeHeader(uint8_t type, long tick);
+};
+
+class InputReplay {
+public:
+    uint64_t masterSeed;
+    std::vector<InputEvent> events;  // Ends with an INPUT_END event
+
+    // False (with error set) on a missing, truncated or foreign file
+    bool load(const char* path);
+    const std::string& error() const { return lastError; }
+
+private:
+    std::string lastError;
+};
+
+// Apply one event to the simulation, the same way the GLUT handlers do.
+// The save-state keys need the history their checkpoints live in; without
+// one they do nothing.
+void applyInput(World& world, const InputEvent& event, StateHistory* history = 0);
+
+// Run a whole recording against a fresh world seeded from its header,
+// keeping the world's level and job system. Checkpoints are taken as the
+// game takes them, so recorded rewinds land on the same states.
+// Returns the number of ticks simulated.
+long replayInput(World& world, const InputReplay& replay);
+
+#endif // INPUT_RECORD_H
@@ -0,0 +1,116 @@
+//
+//  job_system.cpp
+//  Fish-Fillet-Project
+//
+
+#include "job_system.h"
+
+JobSystem::JobSystem(unsigned workerCount)
+    : queues(1), batchFn(0), batchContext(0), pending(0), batchId(0), stopping(false) {
+    if (workerCount == 0) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 0;
+    }
+    std::vector<Queue> sized(workerCount + 1);
+    queues.swap(sized);
+    workers.reserve(workerCount);
+    for (unsigned w = 0; w < workerCount; ++w) {
+        workers.push_back(std::thread(&JobSystem::workerLoop, this, static_cast<size_t>(w)));
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (size_t w = 0; w < workers.size(); ++w) {
+        workers[w].join();
+    }
+}
+
+void JobSystem::run(size_t count, size_t grain, ChunkFn fn, void* context) {
+    size_t chunks = chunkCount(count, grain);
+    if (chunks == 0) return;
+    if (chunks == 1 || workers.empty()) {
+        for (size_t c = 0; c < chunks; ++c) {
+            size_t begin = c * grain;
+            fn(context, c, begin, begin + grain < count ? begin + grain : count);
+        }
+        return;
+    }
+
+    batchFn = fn;
+    batchContext = context;
+    pending.store(chunks, std::memory_order_relaxed);
+
+    // Every queue ran dry in the last batch; start them over
+    for (size_t q = 0; q < queues.size(); ++q) {
+        std::lock_guard<std::mutex> guard(queues[q].lock);
+        queues[q].jobs.clear();
+        queues[q].head = 0;
+    }
+
+    // Deal chunks round-robin so every thread starts on nearby work
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t begin = c * grain;
+        Job job = { c, begin, begin + grain < count ? begin + grain : count };
+        Queue& queue = queues[c % queues.size()];
+        std::lock_guard<std::mutex> guard(queue.lock);
+        queue.jobs.push_back(job);
+    }
+    {
+        std::lock_guard<std::mutex> guard(wakeLock);
+        ++batchId;
+    }
+    wake.notify_all();
+
+    size_t self = queues.size() - 1;
+    drain(self);
+    while (pending.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();  // Others are finishing their last chunk
+    }
+}
+
+bool JobSystem::takeJob(size_t self, Job& job) {
+    {
+        Queue& own = queues[self];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (own.head < own.jobs.size()) {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            return true;
+        }
+    }
+    for (size_t k = 1; k < queues.size(); ++k) {
+        Queue& victim = queues[(self + k) % queues.size()];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (victim.head < victim.jobs.size()) {
+            job = victim.jobs[victim.head++];
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::drain(size_t self) {
+    Job job;
+    while (takeJob(self, job)) {
+        batchFn(batchContext, job.chunk, job.begin, job.end);
+        pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+void JobSystem::workerLoop(size_t self) {
+    unsigned long seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> guard(wakeLock);
+            while (!stopping && batchId == seen) wake.wait(guard);
+            if (stopping) return;
+            seen = batchId;
+        }
+        drain(self);
+    }
+}
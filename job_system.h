@@ -0,0 +1,93 @@
+//
+//  job_system.h
+//  Fish-Fillet-Project
+//
+//  Small work-stealing thread pool for data-parallel loops. parallelFor
+//  cuts [0, count) into fixed chunks and deals them round-robin onto one
+//  queue per thread; each thread pops its own work from the back and steals
+//  from the front of the others when it runs dry. Queues are flat arrays
+//  that keep their capacity, so a batch does not touch the heap once the
+//  pool has seen one as large. The calling thread works
+//  too and returns once every chunk is done.
+//
+//  Chunk boundaries depend only on count and grain, never on thread timing,
+//  so callers that write per-chunk results and merge them in chunk order get
+//  the same answer on any number of threads. Calls must not be nested and
+//  only one thread may call parallelFor at a time.
+//
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem {
+public:
+    // workerCount threads in addition to the caller; 0 picks one fewer than
+    // the hardware thread count
+    explicit JobSystem(unsigned workerCount = 0);
+    ~JobSystem();
+
+    // Threads that execute chunks, including the caller
+    unsigned threadCount() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Number of chunks parallelFor will use for this count and grain
+    static size_t chunkCount(size_t count, size_t grain) {
+        return grain == 0 ? 0 : (count + grain - 1) / grain;
+    }
+
+    // Call fn(chunk, begin, end) for every grain-sized chunk of [0, count)
+    template <class Fn>
+    void parallelFor(size_t count, size_t grain, Fn& fn) {
+        run(count, grain, &invokeChunk<Fn>, &fn);
+    }
+
+private:
+    typedef void (*ChunkFn)(void* context, size_t chunk, size_t begin, size_t end);
+
+    struct Job {
+        size_t chunk, begin, end;
+    };
+
+    // Jobs [head, jobs.size()) are waiting; the owner takes from the back
+    struct Queue {
+        std::mutex lock;
+        std::vector<Job> jobs;
+        size_t head;
+
+        Queue() : head(0) {}
+    };
+
+    std::vector<std::thread> workers;
+    std::vector<Queue> queues;          // One per worker, the caller's last
+
+    // The batch being executed
+    ChunkFn batchFn;
+    void* batchContext;
+    std::atomic<size_t> pending;        // Chunks not yet finished
+
+    std::mutex wakeLock;
+    std::condition_variable wake;
+    unsigned long batchId;              // Bumped for every batch, under wakeLock
+    bool stopping;
+
+    template <class Fn>
+    static void invokeChunk(void* context, size_t chunk, size_t begin, size_t end) {
+        (*static_cast<Fn*>(context))(chunk, begin, end);
+    }
+
+    void run(size_t count, size_t grain, ChunkFn fn, void* context);
+    bool takeJob(size_t self, Job& job);
+    void drain(size_t self);
+    void workerLoop(size_t self);
+
+    JobSystem(const JobSystem&);
+    JobSystem& operator=(const JobSystem&);
+};
+
+#endif // JOB_SYSTEM_H
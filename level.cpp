@@ -0,0 +1,535 @@
+//
+//  level.cpp
+//  Fish-Fillet-Project
+//
+
+#include "level.h"
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const char LEVEL_MAGIC[8] = {'F', 'I', 'S', 'H', 'L', 'V', 'L', '\0'};
+
+struct LevelFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t rulesBytes;      // sizeof(LevelRules) when written
+    uint32_t placedBytes;     // sizeof(PlacedFish) when written
+    uint32_t placedCount;
+    uint32_t placedOffset;    // From the start of the file, 16-byte aligned
+    uint32_t reserved;
+    // LevelRules follows
+};
+
+static void setSpecies(SpeciesDef& s, const char* name, float scale, float r, float g, float b,
+                       uint16_t weight, uint16_t points, bool chases) {
+    std::memset(&s, 0, sizeof(s));
+    std::strncpy(s.name, name, sizeof(s.name) - 1);
+    s.scale = scale;
+    s.color[0] = r;
+    s.color[1] = g;
+    s.color[2] = b;
+    s.weight = weight;
+    s.points = points;
+    s.chases = chases ? 1 : 0;
+}
+
+// Read a whole number for a uint16_t field. Reads through a wide signed
+// type, so "-1" or 70000 come back out of range instead of wrapping.
+static bool readUint16(std::istream& in, uint16_t& value, bool& inRange) {
+    long long wide;
+    if (!(in >> wide)) return false;
+    if (wide < 0 || wide > UINT16_MAX) {
+        inRange = false;
+    } else {
+        value = static_cast<uint16_t>(wide);
+    }
+    return true;
+}
+
+static void setSchooling(SpeciesDef& s, float separation, float alignment, float cohesion) {
+    s.separation = separation;
+    s.alignment = alignment;
+    s.cohesion = cohesion;
+}
+
+BehaviorParams behaviorParams(const LevelRules& rules) {
+    BehaviorParams p;
+    p.fleeDistance2 = rules.fleeDistance * rules.fleeDistance;
+    p.chaseDistance2 = rules.chaseDistance * rules.chaseDistance;
+    p.fleeSpeedMult = rules.fleeSpeedMult;
+    p.chaseSpeedMult = rules.chaseSpeedMult;
+    p.neighborRadius = rules.neighborRadius;
+    p.separationRadius = rules.separationRadius;
+    p.schoolSpeed = FISH_SPEED * rules.schoolSpeedMult;
+    p.huntSpeed = FISH_SPEED * rules.huntSpeedMult;
+    p.worldWidth = rules.worldWidth;
+    p.worldHeight = rules.worldHeight;
+    p.flocking = false;
+    for (int s = 0; s < MAX_SPECIES; ++s) {
+        bool defined = s < rules.speciesCount;
+        p.chases[s] = defined ? rules.species[s].chases : 0;
+        p.separation[s] = defined ? rules.species[s].separation : 0.0f;
+        p.alignment[s] = defined ? rules.species[s].alignment : 0.0f;
+        p.cohesion[s] = defined ? rules.species[s].cohesion : 0.0f;
+        if (p.separation[s] != 0.0f || p.alignment[s] != 0.0f || p.cohesion[s] != 0.0f) p.flocking = true;
+    }
+    if (p.huntSpeed > 0.0f) p.flocking = true;
+    if (!(p.neighborRadius > 0.0f)) p.flocking = false;
+    return p;
+}
+
+Level::Level() : placedFish(0), placedFishCount(0), mapping(0), mappingSize(0) {
+    std::memset(&rules, 0, sizeof(rules));
+    std::strncpy(rules.name, "Default ocean", sizeof(rules.name) - 1);
+    rules.fishCount = NUM_FISH;
+    rules.initialTime = INITIAL_TIME;
+    rules.initialPlayerSize = INITIAL_PLAYER_SIZE;
+    rules.maxPlayerSize = MAX_PLAYER_SIZE;
+    rules.growthIncrement = GROWTH_INCREMENT;
+    rules.fleeDistance = FLEE_DISTANCE;
+    rules.chaseDistance = CHASE_DISTANCE;
+    rules.fleeSpeedMult = FLEE_SPEED_MULT;
+    rules.chaseSpeedMult = CHASE_SPEED_MULT;
+    rules.redWeight = 3;        // 30% red fish, 70% yellow fish
+    rules.yellowWeight = 7;
+    rules.redPoints = 3;        // Bonus points for eating red fish
+    rules.redGrowthMult = 2.0f;
+    // 40% small, 40% medium, 20% large; large fish chase like red ones
+    rules.speciesCount = 3;
+    setSpecies(rules.species[SMALL], "small", SIZE_MULTIPLIERS[SMALL], 1.0f, 0.95f, 0.3f, 4, 1, false);
+    setSpecies(rules.species[MEDIUM], "medium", SIZE_MULTIPLIERS[MEDIUM], 1.0f, 0.9f, 0.2f, 4, 2, false);
+    setSpecies(rules.species[LARGE], "large", SIZE_MULTIPLIERS[LARGE], 1.0f, 0.85f, 0.15f, 2, 3, true);
+    // Small fish school tightly, medium ones loosely, large ones hunt alone
+    setSchooling(rules.species[SMALL], 1.0f, 0.6f, 0.5f);
+    setSchooling(rules.species[MEDIUM], 1.0f, 0.4f, 0.25f);
+    setSchooling(rules.species[LARGE], 1.0f, 0.0f, 0.0f);
+    rules.neighborRadius = 48.0f;
+    rules.separationRadius = 24.0f;
+    rules.schoolSpeedMult = 1.0f;
+    rules.huntSpeedMult = 1.2f;
+    rules.worldWidth = WINDOW_WIDTH;
+    rules.worldHeight = OCEAN_HEIGHT;
+}
+
+Level::~Level() {
+    unmap();
+}
+
+float Level::largestScale() const {
+    float largest = 0.0f;
+    for (int s = 0; s < rules.speciesCount; ++s) {
+        if (rules.species[s].scale > largest) largest = rules.species[s].scale;
+    }
+    return largest;
+}
+
+void Level::unmap() {
+    if (!mapping) return;
+#ifdef _WIN32
+    UnmapViewOfFile(mapping);
+#else
+    munmap(mapping, mappingSize);
+#endif
+    mapping = 0;
+    mappingSize = 0;
+}
+
+// Everything a loaded level must satisfy before the simulation trusts it
+static bool validRules(const LevelRules& r, std::string& error) {
+    if (r.speciesCount < 1 || r.speciesCount > MAX_SPECIES) {
+        error = "a level needs between 1 and 8 species";
+        return false;
+    }
+    long totalWeight = 0;
+    for (int s = 0; s < r.speciesCount; ++s) {
+        if (!(r.species[s].scale > 0.0f)) {
+            error = std::string("species ") + r.species[s].name + " needs a positive scale";
+            return false;
+        }
+        totalWeight += r.species[s].weight;
+    }
+    if (totalWeight == 0 || r.redWeight + r.yellowWeight == 0) {
+        error = "spawn weights must not all be zero";
+        return false;
+    }
+    if (r.neighborRadius < 0.0f || r.separationRadius < 0.0f || r.separationRadius > r.neighborRadius) {
+        error = "separation_radius must be between 0 and neighbor_radius";
+        return false;
+    }
+    if (!(r.worldWidth >= WINDOW_WIDTH && r.worldHeight >= OCEAN_HEIGHT) ||
+        r.worldWidth > MAX_WORLD_SIZE || r.worldHeight > MAX_WORLD_SIZE) {
+        error = "world_width and world_height must cover the window (1200 x 500) and be at most 200000";
+        return false;
+    }
+    if (r.fishCount > MAX_LEVEL_FISH) {
+        error = "fish must be at most 1000000";
+        return false;
+    }
+    if (r.initialTime <= 0 || !(r.initialPlayerSize > 0.0f) || r.maxPlayerSize < r.initialPlayerSize) {
+        error = "time and player sizes must be positive, with max_player_size >= player_size";
+        return false;
+    }
+    return true;
+}
+
+static bool validPlacements(const LevelRules& r, const PlacedFish* fish, size_t count, std::string& error) {
+    for (size_t i = 0; i < count; ++i) {
+        if (fish[i].species >= r.speciesCount) {
+            error = "placed fish uses a species the level does not define";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Level::load(const char* path, std::string& error) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        error = std::string("cannot open ") + path;
+        return false;
+    }
+    char magic[sizeof(LEVEL_MAGIC)] = {0};
+    size_t got = std::fread(magic, 1, sizeof(magic), f);
+    if (got == sizeof(magic) && std::memcmp(magic, LEVEL_MAGIC, sizeof(magic)) == 0) {
+        std::fclose(f);
+        return loadBinary(path, error);
+    }
+
+    std::string text(magic, got);
+    char buffer[4096];
+    size_t n;
+    while ((n = std::fread(buffer, 1, sizeof(buffer), f)) > 0) text.append(buffer, n);
+    std::fclose(f);
+    if (!parseText(text, error)) {
+        error = std::string(path) + ":" + error;
+        return false;
+    }
+    return true;
+}
+
+bool Level::loadBinary(const char* path, std::string& error) {
+    unmap();
+    ownedFish.clear();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, 0,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE) {
+        error = std::string("cannot open ") + path;
+        return false;
+    }
+    LARGE_INTEGER size;
+    GetFileSizeEx(file, &size);
+    HANDLE view = CreateFileMappingA(file, 0, PAGE_READONLY, 0, 0, 0);
+    CloseHandle(file);
+    if (!view) {
+        error = std::string("cannot map ") + path;
+        return false;
+    }
+    mapping = MapViewOfFile(view, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(view);
+    mappingSize = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        error = std::string("cannot open ") + path;
+        return false;
+    }
+    struct stat info;
+    fstat(fd, &info);
+    mappingSize = static_cast<size_t>(info.st_size);
+    void* view = mmap(0, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    mapping = view == MAP_FAILED ? 0 : view;
+#endif
+    if (!mapping) {
+        error = std::string("cannot map ") + path;
+        return false;
+    }
+
+    const unsigned char* bytes = static_cast<const unsigned char*>(mapping);
+    LevelFileHeader header;
+    if (mappingSize < sizeof(header) + sizeof(LevelRules)) {
+        error = std::string(path) + " is truncated";
+        unmap();
+        return false;
+    }
+    std::memcpy(&header, bytes, sizeof(header));
+    if (header.version != LEVEL_FILE_VERSION || header.rulesBytes != sizeof(LevelRules) ||
+        header.placedBytes != sizeof(PlacedFish)) {
+        error = std::string(path) + " was compiled by a different version; recompile it";
+        unmap();
+        return false;
+    }
+    if (header.placedOffset % 16 != 0 ||
+        header.placedOffset + static_cast<uint64_t>(header.placedCount) * sizeof(PlacedFish) > mappingSize) {
+        error = std::string(path) + " is truncated";
+        unmap();
+        return false;
+    }
+
+    LevelRules loaded;
+    std::memcpy(&loaded, bytes + sizeof(header), sizeof(loaded));
+    const PlacedFish* fish = reinterpret_cast<const PlacedFish*>(bytes + header.placedOffset);
+    if (!validRules(loaded, error) || !validPlacements(loaded, fish, header.placedCount, error)) {
+        error = std::string(path) + ": " + error;
+        unmap();
+        return false;
+    }
+    rules = loaded;
+    rules.name[sizeof(rules.name) - 1] = '\0';
+    placedFish = header.placedCount ? fish : 0;
+    placedFishCount = header.placedCount;
+    return true;
+}
+
+bool Level::writeBinary(const char* path, std::string& error) const {
+    LevelFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, LEVEL_MAGIC, sizeof(LEVEL_MAGIC));
+    header.version = LEVEL_FILE_VERSION;
+    header.rulesBytes = sizeof(LevelRules);
+    header.placedBytes = sizeof(PlacedFish);
+    header.placedCount = static_cast<uint32_t>(placedFishCount);
+    header.placedOffset = static_cast<uint32_t>((sizeof(header) + sizeof(LevelRules) + 15) / 16 * 16);
+
+    // Write beside the target and rename over it, so a game with the old
+    // file mapped keeps its pages and never sees a half-written level
+    std::string temp = std::string(path) + ".tmp";
+    std::FILE* f = std::fopen(temp.c_str(), "wb");
+    if (!f) {
+        error = std::string("cannot write ") + temp;
+        return false;
+    }
+    static const char padding[16] = {0};
+    size_t pad = header.placedOffset - sizeof(header) - sizeof(LevelRules);
+    bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1 &&
+              std::fwrite(&rules, sizeof(rules), 1, f) == 1 &&
+              std::fwrite(padding, 1, pad, f) == pad &&
+              (placedFishCount == 0 ||
+               std::fwrite(placedFish, sizeof(PlacedFish), placedFishCount, f) == placedFishCount);
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) {
+        std::remove(temp.c_str());
+        error = std::string("failed writing ") + temp;
+        return false;
+    }
+#ifdef _WIN32
+    ok = MoveFileExA(temp.c_str(), path, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    ok = std::rename(temp.c_str(), path) == 0;
+#endif
+    if (!ok) {
+        std::remove(temp.c_str());
+        error = std::string("cannot replace ") + path;
+    }
+    return ok;
+}
+
+std::shared_ptr<const Level> Level::withRules(const LevelRules& newRules, std::string& error) const {
+    if (!validRules(newRules, error) || !validPlacements(newRules, placedFish, placedFishCount, error)) {
+        return std::shared_ptr<const Level>();
+    }
+    std::shared_ptr<Level> copy(new Level());
+    copy->rules = newRules;
+    copy->ownedFish.assign(placedFish, placedFish + placedFishCount);
+    copy->placedFish = copy->ownedFish.empty() ? 0 : &copy->ownedFish[0];
+    copy->placedFishCount = copy->ownedFish.size();
+    return copy;
+}
+
+static int findSpecies(const LevelRules& rules, const std::string& name) {
+    for (int s = 0; s < rules.speciesCount; ++s) {
+        if (name == rules.species[s].name) return s;
+    }
+    return -1;
+}
+
+// Text format: one "key values..." per line, '#' starts a comment
+bool Level::parseText(const std::string& text, std::string& error) {
+    unmap();
+    Level defaults;
+    LevelRules parsed = defaults.rules;
+    std::vector<PlacedFish> fish;
+    bool speciesListed = false;
+
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line)) {
+        ++lineNumber;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.erase(hash);
+        std::istringstream in(line);
+        std::string key;
+        if (!(in >> key)) continue;
+
+        bool ok = true;
+        bool inRange = true;  // Cleared by readUint16
+        if (key == "name") {
+            std::string rest;
+            std::getline(in >> std::ws, rest);
+            std::memset(parsed.name, 0, sizeof(parsed.name));
+            std::strncpy(parsed.name, rest.c_str(), sizeof(parsed.name) - 1);
+        } else if (key == "fish") {
+            long long count;
+            ok = static_cast<bool>(in >> count);
+            if (ok && (count < 0 || count > MAX_LEVEL_FISH)) {
+                error = std::to_string(lineNumber) + ": fish must be between 0 and 1000000";
+                return false;
+            }
+            parsed.fishCount = static_cast<uint32_t>(count);
+        } else if (key == "time") {
+            ok = static_cast<bool>(in >> parsed.initialTime);
+        } else if (key == "player_size") {
+            ok = static_cast<bool>(in >> parsed.initialPlayerSize);
+        } else if (key == "max_player_size") {
+            ok = static_cast<bool>(in >> parsed.maxPlayerSize);
+        } else if (key == "growth") {
+            ok = static_cast<bool>(in >> parsed.growthIncrement);
+        } else if (key == "flee_distance") {
+            ok = static_cast<bool>(in >> parsed.fleeDistance);
+        } else if (key == "chase_distance") {
+            ok = static_cast<bool>(in >> parsed.chaseDistance);
+        } else if (key == "flee_speed") {
+            ok = static_cast<bool>(in >> parsed.fleeSpeedMult);
+        } else if (key == "chase_speed") {
+            ok = static_cast<bool>(in >> parsed.chaseSpeedMult);
+        } else if (key == "red") {
+            ok = readUint16(in, parsed.redWeight, inRange) && readUint16(in, parsed.yellowWeight, inRange);
+        } else if (key == "red_points") {
+            ok = readUint16(in, parsed.redPoints, inRange);
+        } else if (key == "red_growth") {
+            ok = static_cast<bool>(in >> parsed.redGrowthMult);
+        } else if (key == "species") {
+            if (!speciesListed) {
+                parsed.speciesCount = 0;  // The first species line replaces the defaults
+                speciesListed = true;
+            }
+            if (parsed.speciesCount == MAX_SPECIES) {
+                error = std::to_string(lineNumber) + ": more than 8 species";
+                return false;
+            }
+            std::string name;
+            float scale, r, g, b;
+            uint16_t weight = 0, points = 0;
+            int chases;
+            ok = static_cast<bool>(in >> name >> scale) && readUint16(in, weight, inRange) &&
+                 readUint16(in, points, inRange) && static_cast<bool>(in >> chases >> r >> g >> b);
+            ok = ok && inRange;
+            if (ok) {
+                setSpecies(parsed.species[parsed.speciesCount++], name.c_str(), scale, r, g, b,
+                           weight, points, chases != 0);
+            }
+        } else if (key == "neighbor_radius") {
+            ok = static_cast<bool>(in >> parsed.neighborRadius);
+        } else if (key == "separation_radius") {
+            ok = static_cast<bool>(in >> parsed.separationRadius);
+        } else if (key == "school_speed") {
+            ok = static_cast<bool>(in >> parsed.schoolSpeedMult);
+        } else if (key == "hunt_speed") {
+            ok = static_cast<bool>(in >> parsed.huntSpeedMult);
+        } else if (key == "world_width") {
+            ok = static_cast<bool>(in >> parsed.worldWidth);
+        } else if (key == "world_height") {
+            ok = static_cast<bool>(in >> parsed.worldHeight);
+        } else if (key == "school") {
+            std::string species;
+            float separation, alignment, cohesion;
+            ok = static_cast<bool>(in >> species >> separation >> alignment >> cohesion);
+            if (ok) {
+                int index = findSpecies(parsed, species);
+                if (index < 0) {
+                    error = std::to_string(lineNumber) + ": unknown species '" + species + "'";
+                    return false;
+                }
+                setSchooling(parsed.species[index], separation, alignment, cohesion);
+            }
+        } else if (key == "place") {
+            float x, y, direction;
+            std::string species;
+            int red;
+            ok = static_cast<bool>(in >> x >> y >> species >> red >> direction);
+            if (ok) {
+                int index = findSpecies(parsed, species);
+                if (index < 0) {
+                    error = std::to_string(lineNumber) + ": unknown species '" + species +
+                            "' (define species before placing them)";
+                    return false;
+                }
+                PlacedFish p;
+                std::memset(&p, 0, sizeof(p));
+                p.x = x;
+                p.y = y;
+                p.direction = direction;
+                p.species = static_cast<uint8_t>(index);
+                p.isRed = red ? 1 : 0;
+                fish.push_back(p);
+            }
+        } else {
+            error = std::to_string(lineNumber) + ": unknown key '" + key + "'";
+            return false;
+        }
+        if (!inRange) {
+            error = std::to_string(lineNumber) + ": '" + key + "' counts must be between 0 and 65535";
+            return false;
+        }
+        if (!ok) {
+            error = std::to_string(lineNumber) + ": bad value for '" + key + "'";
+            return false;
+        }
+    }
+
+    if (!validRules(parsed, error)) return false;
+    rules = parsed;
+    ownedFish.swap(fish);
+    placedFish = ownedFish.empty() ? 0 : &ownedFish[0];
+    placedFishCount = ownedFish.size();
+    return true;
+}
+
+std::shared_ptr<const Level> defaultLevel() {
+    static std::shared_ptr<const Level> level(new Level());
+    return level;
+}
+
+static std::time_t modificationTime(const std::string& path) {
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? info.st_mtime : 0;
+}
+
+LevelWatcher::LevelWatcher(const std::string& path) : filePath(path), lastWrite(0), failedWrite(0) {}
+
+// The time is taken before reading, so a write landing mid-load shows up as
+// a change on the next poll
+std::shared_ptr<const Level> LevelWatcher::load(std::string& error) {
+    std::time_t written = modificationTime(filePath);
+    std::shared_ptr<Level> level(new Level());
+    if (!level->load(filePath.c_str(), error)) {
+        failedWrite = written;
+        return std::shared_ptr<const Level>();
+    }
+    lastWrite = written;
+    return level;
+}
+
+// A failed load is retried on every poll until one succeeds: the file may
+// have been caught half written within the same second as its final write.
+// The error is only reported the first time for each modification time.
+std::shared_ptr<const Level> LevelWatcher::poll(std::string& error) {
+    std::time_t now = modificationTime(filePath);
+    if (now == 0 || now == lastWrite) return std::shared_ptr<const Level>();
+    bool reported = now == failedWrite;
+    std::shared_ptr<const Level> level = load(error);
+    if (!level && reported) error.clear();
+    return level;
+}
@@ -0,0 +1,168 @@
+//
+//  level.h
+//  Fish-Fillet-Project
+//
+//  Level and species definitions. Levels are written as text (see
+//  levels/default.level) and compiled with --compile-level into a binary
+//  image whose header and rules are plain structs and whose placed fish are
+//  a flat array. Loading a compiled level maps the file, checks the header
+//  and points into the mapping, so start-up cost does not grow with the
+//  number of fish. Text levels are still accepted directly for editing.
+//
+//  Compiled files are little-endian and tied to LEVEL_FILE_VERSION and the
+//  struct sizes below; the loader rejects anything else.
+//
+
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "game_config.h"
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+const int MAX_SPECIES = 8;
+const uint32_t LEVEL_FILE_VERSION = 3;
+const float MAX_WORLD_SIZE = 200000.0f;    // Longest side of a scrolling world, in pixels
+const uint32_t MAX_LEVEL_FISH = 1000000;   // Most random fish a round may spawn
+
+struct SpeciesDef {
+    char name[16];
+    float scale;            // Size relative to a 1.0 fish
+    float color[3];         // Body colour of the yellow (non-red) variant
+    uint16_t weight;        // Relative spawn weight
+    uint16_t points;        // Score for eating a yellow one
+    uint8_t chases;         // Chases a smaller player, and smaller fish, even when not red
+    uint8_t reserved[3];
+    float separation;       // Schooling weights; all zero swims alone
+    float alignment;
+    float cohesion;
+};
+
+struct LevelRules {
+    char name[32];
+    uint32_t fishCount;         // Random fish per round (ignored when fish are placed)
+    int32_t initialTime;        // Seconds on the game clock
+    float initialPlayerSize;
+    float maxPlayerSize;
+    float growthIncrement;      // Player growth per yellow fish eaten
+    float fleeDistance;
+    float chaseDistance;
+    float fleeSpeedMult;
+    float chaseSpeedMult;
+    uint16_t redWeight;         // A fish is red with odds red : yellow
+    uint16_t yellowWeight;
+    uint16_t redPoints;         // Score for eating a red fish of any species
+    uint16_t speciesCount;
+    float redGrowthMult;        // Growth for a red fish, in growth increments
+    SpeciesDef species[MAX_SPECIES];
+    float neighborRadius;       // How far a fish sees other fish
+    float separationRadius;     // Closer than this, schoolmates push apart
+    float schoolSpeedMult;      // Cap on schooling speed, in FISH_SPEED
+    float huntSpeedMult;        // Fish-vs-fish chase and flee speed; 0 turns hunting off
+    float worldWidth;           // Ocean size; larger than the window scrolls (chunk_map.h)
+    float worldHeight;
+};
+
+// A fish with a fixed start, for hand-built levels
+struct PlacedFish {
+    float x, y;
+    float direction;        // Drift per tick; the sign is the facing
+    uint8_t species;
+    uint8_t isRed;
+    uint8_t reserved[2];
+};
+
+// Per-tick behavior inputs derived from LevelRules
+struct BehaviorParams {
+    float fleeDistance2;
+    float chaseDistance2;
+    float fleeSpeedMult;
+    float chaseSpeedMult;
+    unsigned char chases[MAX_SPECIES];
+
+    // Schooling and fish-vs-fish hunting (flocking.h)
+    bool flocking;              // False when no species schools and hunting is off
+    float neighborRadius;
+    float separationRadius;
+    float schoolSpeed;          // Already multiplied by FISH_SPEED
+    float huntSpeed;
+    float separation[MAX_SPECIES];
+    float alignment[MAX_SPECIES];
+    float cohesion[MAX_SPECIES];
+
+    // Fish wrap around at worldWidth and keep between the seabed and the surface
+    float worldWidth;
+    float worldHeight;
+};
+
+BehaviorParams behaviorParams(const LevelRules& rules);
+
+class Level {
+public:
+    LevelRules rules;
+
+    // The built-in level: the constants in game_config.h
+    Level();
+    ~Level();
+
+    size_t placedCount() const { return placedFishCount; }
+    const PlacedFish* placed() const { return placedFish; }
+
+    // Largest species scale, for sizing collision queries
+    float largestScale() const;
+
+    // Load a compiled level, or parse a text one; decided by the file's magic
+    bool load(const char* path, std::string& error);
+
+    // Parse the text format. Keys that are left out keep their defaults.
+    bool parseText(const std::string& text, std::string& error);
+
+    bool writeBinary(const char* path, std::string& error) const;
+
+    // A copy of this level, placed fish included, playing by other rules.
+    // Null, with error set, if the rules would not load.
+    std::shared_ptr<const Level> withRules(const LevelRules& newRules, std::string& error) const;
+
+private:
+    std::vector<PlacedFish> ownedFish;  // Text levels
+    const PlacedFish* placedFish;       // ownedFish or the mapping
+    size_t placedFishCount;
+    void* mapping;
+    size_t mappingSize;
+
+    bool loadBinary(const char* path, std::string& error);
+    void unmap();
+
+    Level(const Level&);
+    Level& operator=(const Level&);
+};
+
+// Shared instance of the built-in level
+std::shared_ptr<const Level> defaultLevel();
+
+// Reloads a level file when its modification time changes
+class LevelWatcher {
+public:
+    explicit LevelWatcher(const std::string& path);
+
+    const std::string& path() const { return filePath; }
+
+    // Load the file now and, if it loads, remember its time
+    std::shared_ptr<const Level> load(std::string& error);
+
+    // A freshly loaded level if the file changed since the last successful
+    // load, otherwise null. A failed reload returns null and is tried again
+    // on the next poll; error is set the first time it fails.
+    std::shared_ptr<const Level> poll(std::string& error);
+
+private:
+    std::string filePath;
+    std::time_t lastWrite;      // Of the file last loaded
+    std::time_t failedWrite;    // Of the file last failing to load
+};
+
+#endif // LEVEL_H
@@ -11,69 +11,65 @@
 #include <GLUT/glut.h>
 #else
 #include <GL/glut.h>
+#include <GL/freeglut_ext.h>  // glutGetProcAddress, for the swap interval
 #endif
 #include <cmath>
+#include <csignal>
 #include <cstring>
 #include <cstdlib>
 #include <cstdio>
 #include <ctime>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
 #include <vector>
+#include "world.h"
+#include "fish_renderer.h"
+#include "background.h"
+#include "offscreen.h"
+#include "input_record.h"
+#include "profiler.h"
+#include "job_system.h"
+#include "sim_thread.h"
+#include "text_renderer.h"
+#include "alloc_stats.h"
+#include "batch_runner.h"
+#include "frame_scheduler.h"
+#include "world_state.h"
+#include "particles.h"
+#include "particle_renderer.h"
 #ifdef _WIN32
 #include <windows.h>
 #include <mmsystem.h>
 #pragma comment(lib, "winmm.lib")
+#else
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
-// Game Constants
-const int WINDOW_WIDTH = 1200;
-const int WINDOW_HEIGHT = 600;
-const int OCEAN_HEIGHT = 500;
-const int NUM_FISH = 20;
-const int INITIAL_TIME = 20;
-const float FISH_SIZE = 20.0f;
-const float COLLISION_RADIUS = 15.0f;
-const float FISH_SPEED = 0.4f;
-const int WAVE_SEGMENTS = 100;
-const int WAVE_SPACING = 60;
-const float PI = 3.1415926f;
-
-// Behavior tuning
-const float SAFE_SPAWN_DISTANCE = 150.0f;   // Minimum distance from player when spawning fish
-const float FLEE_DISTANCE = 220.0f;         // Distance at which smaller fish start fleeing
-const float CHASE_DISTANCE = 260.0f;        // Distance at which bigger/red fish start chasing
-const float FLEE_SPEED_MULT = 1.8f;         // Speed multiplier for fleeing fish
-const float CHASE_SPEED_MULT = 1.4f;        // Speed multiplier for chasing fish
-
-// Coral sway
-const int CORAL_COUNT = 14;
-const float CORAL_SWAY_SPEED = 0.025f;
-float coralPhase = 0.0f;
-
-// Fish size types
-enum FishSizeType {
-    SMALL = 0,    // 0.8x size
-    MEDIUM = 1,   // 1.0x size
-    LARGE = 2     // 1.5x size
-};
-
-const float SIZE_MULTIPLIERS[] = {0.8f, 1.0f, 1.5f};
-const float GROWTH_INCREMENT = 0.05f;  // Player grows by this amount per fish eaten
-const float INITIAL_PLAYER_SIZE = 1.0f;
-const float MAX_PLAYER_SIZE = 2.5f;
-
 // Game State
-bool isGameOver = false;
-int score = 0;
-int gameTime = INITIAL_TIME;
-bool allYellowFishGone = false;
-bool soundPlayed = false;
-float playerSizeScale = INITIAL_PLAYER_SIZE;  // Player growth scale
-float prevMouseX = WINDOW_WIDTH / 2.0f;  // Previous mouse X position for direction calculation
-
-// Wave Animation
-bool waveUp = true;
-int waveDelta = 0;
-const int MAX_WAVE_DELTA = 15;
+World world;                 // Owned by the simulation thread while the window is open
+SimulationThread simulation;
+FishRenderer fishRenderer;
+ParticleSystem particles;    // Render thread only; never feeds back into the world
+ParticleRenderer particleRenderer;
+double particleSeconds = -1.0;  // Animation time of the last particle update
+OceanBackground background;
+bool textEnabled = true;  // GLUT bitmap fonts need glutInit, which offscreen mode skips
+TextRenderer hudText;
+TextLabel scoreCaption, scoreValue, sizeCaption, sizeValue, timeCaption, timeValue, finalScore;
+InputRecorder recorder;   // Only open with --record
+bool profileOverlay = false;  // F3 toggles the phase timing overlay
+uint64_t renderAllocs = 0;    // Heap allocations in the last frame, per thread
+uint64_t simAllocs = 0;
+FrameScheduler frameScheduler;  // Paces the window's redraws (--fps, F4)
+bool frameStatsAtExit = false;  // --frame-stats
+const WorldState* startState = 0;  // --load-state: the round to open with
+const char* crashDumpPath = "fish_crash.state";
+static_assert(INPUT_KEY_RESTART == GLUT_KEY_F2, "replay must restart on the same key as the game");
+static_assert(INPUT_KEY_SAVE_STATE == GLUT_KEY_F5 && INPUT_KEY_LOAD_STATE == GLUT_KEY_F6 &&
+              INPUT_KEY_REWIND == GLUT_KEY_F7, "replay must handle save states on the same keys as the game");
 
 // Sound Effects (non-blocking, shorter duration to reduce delay)
 void playSound(int type) {
@@ -91,610 +87,749 @@ void playSound(int type) {
 #endif
 }
 
-// Text Display Functions
-void drawText(const char *str, int x, int y) {
-    glRasterPos2d(x, y);
-    for (int i = 0; i < static_cast<int>(std::strlen(str)); i++)
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, str[i]);
+// Text Display Functions: text is queued and drawn in one batch by
+// hudText.flush(). Labels keep their quads until their text changes.
+void drawText(const char *str, int x, int y, const float color[3]) {
+    if (!textEnabled) return;
+    hudText.queue(FONT_HELVETICA_12, x, y, str, color);
 }
 
-void drawScore(int x, int y, int value) {
-    glRasterPos2d(x, y);
-    if (value < 0) {
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, '-');
-        value = -value;
-    }
+void drawLargeText(const char *str, int x, int y, const float color[3]) {
+    if (!textEnabled) return;
+    hudText.queue(FONT_TIMES_ROMAN_24, x, y, str, color);
+}
+
+void drawLabel(TextLabel& label, const char *str, int x, int y, const float color[3]) {
+    if (!textEnabled) return;
+    label.set(hudText, FONT_HELVETICA_12, x, y, str, color);
+    hudText.queue(label);
+}
+
+void drawScore(TextLabel& label, int x, int y, int value, const float color[3]) {
     char scoreStr[32];
     std::snprintf(scoreStr, sizeof(scoreStr), "%d", value);
-    for (int i = 0; scoreStr[i] != '\0'; i++)
-        glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, scoreStr[i]);
+    drawLabel(label, scoreStr, x, y, color);
 }
 
-void drawLargeText(const char *str, int x, int y) {
-    glRasterPos2d(x, y);
-    for (int i = 0; i < static_cast<int>(std::strlen(str)); i++)
-        glutBitmapCharacter(GLUT_BITMAP_TIMES_ROMAN_24, str[i]);
+// Initialization
+void initGame() {
+    glClearColor(0.07f, 0.01f, 0.75f, 1.0f);
+    std::string error;
+    if (!startState || !startState->restore(world, error)) world.reset();
+    glMatrixMode(GL_PROJECTION);
+    gluOrtho2D(0.0, WINDOW_WIDTH, 0.0, WINDOW_HEIGHT);
 }
 
-// Wave Drawing
-void drawWave(float cx, float cy, float radius) {
-    glBegin(GL_POLYGON);
-    for (int i = 0; i < WAVE_SEGMENTS; i++) {
-        float theta = 2.0f * PI * float(i) / float(WAVE_SEGMENTS);
-        float x = radius * std::cos(theta - 44.92f);
-        float y = radius * std::sin(theta - 44.92f);
-        glVertex2f(x + cx, y + cy + waveDelta);
-    }
-    glEnd();
+// Input Handlers: the simulation thread applies (and records) them
+void mouseMove(int x, int y) {
+    simulation.postMouse(x, y);
 }
 
-void drawOcean() {
-    // Ocean background gradient
-    glBegin(GL_QUADS);
-    glColor3f(0.1f, 0.4f, 0.8f);
-    glVertex2f(0, 0);
-    glVertex2f(WINDOW_WIDTH, 0);
-    glColor3f(0.05f, 0.2f, 0.5f);
-    glVertex2f(WINDOW_WIDTH, OCEAN_HEIGHT);
-    glVertex2f(0, OCEAN_HEIGHT);
-    glEnd();
-
-    // Animated waves
-    glColor3f(0.15f, 0.5f, 0.9f);
-    for (int i = 0; i <= WINDOW_WIDTH; i += WAVE_SPACING) {
-        drawWave(i, OCEAN_HEIGHT, 40);
+void keyboard(int key, int x, int y) {
+    simulation.postKey(key);
+    if (key == GLUT_KEY_F3) {
+        profileOverlay = !profileOverlay;
+        profiler().setEnabled(profileOverlay);
     }
-    
-    glColor3f(0.2f, 0.6f, 1.0f);
-    for (int i = 30; i <= WINDOW_WIDTH; i += WAVE_SPACING) {
-        drawWave(i, OCEAN_HEIGHT, 35);
+    if (key == GLUT_KEY_F4) {
+        // Cycle 30 -> 60 -> 120 -> unlocked -> 30
+        int rate = frameScheduler.targetRate();
+        int next = rate == 30 ? 60 : rate == 60 ? 120 : rate == 120 ? FRAME_RATE_UNLOCKED : 30;
+        frameScheduler.setTargetRate(next);
     }
-    
-    // Update wave animation
-    if (std::abs(waveDelta) > MAX_WAVE_DELTA) waveUp = !waveUp;
-    waveDelta += waveUp ? 1 : -1;
 }
 
-// Coral / seaweed sway for extra depth
-void drawCoral() {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glColor4f(0.3f, 0.7f, 0.4f, 0.6f);
-
-    float baseHeight = 60.0f;
-    for (int i = 0; i < CORAL_COUNT; ++i) {
-        float x = 40.0f + i * (WINDOW_WIDTH / static_cast<float>(CORAL_COUNT));
-        float sway = std::sin(coralPhase + i * 0.6f) * 8.0f;
-        float height = baseHeight + std::sin(coralPhase * 0.8f + i) * 20.0f;
+// Redraw whenever the scheduler says a frame is due. Waits in short slices
+// so GLUT keeps delivering input in between.
+void idle() {
+    if (frameScheduler.waitForFrame(std::chrono::milliseconds(4))) glutPostRedisplay();
+}
 
-        glBegin(GL_QUADS);
-        glVertex2f(x - 6.0f + sway, 0);
-        glVertex2f(x + 6.0f + sway, 0);
-        glVertex2f(x + 4.0f, height);
-        glVertex2f(x - 4.0f, height);
-        glEnd();
+// Ask the driver to sync buffer swaps to the display; false if it cannot
+bool setSwapInterval(int interval) {
+#if defined(_WIN32)
+    typedef BOOL (WINAPI *SwapIntervalFn)(int);
+    SwapIntervalFn swapInterval = reinterpret_cast<SwapIntervalFn>(glutGetProcAddress("wglSwapIntervalEXT"));
+    return swapInterval && swapInterval(interval);
+#elif defined(__APPLE__)
+    (void)interval;
+    return false;
+#else
+    typedef int (*SwapIntervalFn)(int);  // Both return 0 on success
+    const char* names[] = {"glXSwapIntervalMESA", "glXSwapIntervalSGI"};
+    for (int i = 0; i < 2; ++i) {
+        SwapIntervalFn swapInterval = reinterpret_cast<SwapIntervalFn>(glutGetProcAddress(names[i]));
+        if (swapInterval && swapInterval(interval) == 0) return true;
+    }
+    return false;
+#endif
+}
 
-        // Add a lighter tip
-        glColor4f(0.4f, 0.9f, 0.5f, 0.7f);
-        glBegin(GL_TRIANGLES);
-        glVertex2f(x - 5.0f + sway, height);
-        glVertex2f(x + 5.0f + sway, height);
-        glVertex2f(x + sway, height + 14.0f);
-        glEnd();
-        glColor4f(0.3f, 0.7f, 0.4f, 0.6f);
+// Turn simulation events into sounds and particles at the player, who is
+// where every event happens. The round-ending sound comes from the event
+// too, so a restart never replays it for a stale frame. A round's end
+// clears the pool so its burst plays out alone over the game over box.
+void handleWorldEvent(WorldEvent event, const WorldSnapshot& view) {
+    static const unsigned char gold[3] = {255, 215, 40};
+    static const unsigned char red[3] = {255, 70, 40};
+    static const unsigned char white[3] = {255, 255, 255};
+    float x = view.playerX, y = view.playerY;
+    switch (event) {
+        case EVENT_FISH_EATEN:
+            playSound(0);
+            particles.emitScales(x, y, 14, gold, 120.0f);
+            particles.emitBubbles(x, y, 6);
+            break;
+        case EVENT_PLAYER_HIT:
+            playSound(1);
+            playSound(2);
+            particles.clear();
+            particles.emitScales(x, y, 80, red, 260.0f);
+            particles.emitBubbles(x, y, 30);
+            break;
+        case EVENT_TIME_UP:
+            playSound(2);
+            particles.clear();
+            particles.emitBubbles(x, y, 40);
+            break;
+        case EVENT_GAME_WON:
+            playSound(3);
+            particles.clear();
+            particles.emitScales(x, y, 60, gold, 300.0f);
+            particles.emitScales(x, y, 40, red, 300.0f);
+            particles.emitScales(x, y, 40, white, 200.0f);
+            particles.emitBubbles(x, y, 40);
+            break;
     }
+}
 
-    glDisable(GL_BLEND);
+// Move the particles on to `seconds` of animation time, topping up the
+// plankton in view while the round is played
+void stepParticles(const WorldSnapshot& view, double seconds) {
+    ProfileScope scope(PHASE_PARTICLES);
+    float dt = particleSeconds < 0.0 ? 0.0f : static_cast<float>(seconds - particleSeconds);
+    particleSeconds = seconds;
+    if (!view.isGameOver) particles.emitPlankton(view.cameraX, view.cameraY, WINDOW_WIDTH, OCEAN_HEIGHT, dt);
+    particles.update(dt);
+}
+
+// Particles over whatever is drawn so far, seen through the camera
+void drawParticles(const WorldSnapshot& view) {
+    ProfileScope scope(PHASE_PARTICLES);
+    glPushMatrix();
+    glTranslatef(-view.cameraX, -view.cameraY, 0.0f);
+    particleRenderer.draw(particles, view.cameraX, view.cameraY, WINDOW_WIDTH, OCEAN_HEIGHT);
+    glPopMatrix();
 }
 
-// Fish Class
-class Fish {
-public:
-    bool isPlayer;
-    bool isRedFish;
-    FishSizeType sizeType;
-    float x, y;
-    float direction;
-    float sizeScale;  // Individual size scale for this fish
+// Draw one frame of view into the current buffer; the waves and coral are
+// posed for `seconds` of animation time, whatever the frame rate
+void renderScene(const WorldSnapshot& view, double seconds) {
+    glClear(GL_COLOR_BUFFER_BIT);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     
-    Fish(bool player = false) : isPlayer(player) {
-        if (isPlayer) {
-            x = WINDOW_WIDTH / 2.0f;
-            y = WINDOW_HEIGHT / 2.0f;
-            sizeScale = INITIAL_PLAYER_SIZE;
-            sizeType = MEDIUM;
-            direction = FISH_SPEED;  // Default direction for player (right)
-        } else {
-            isRedFish = (rand() % 10 < 3);  // 30% red fish, 70% yellow fish
-            // Randomly assign size type: 40% small, 40% medium, 20% large
-            int sizeRoll = rand() % 10;
-            if (sizeRoll < 4) {
-                sizeType = SMALL;
-            } else if (sizeRoll < 8) {
-                sizeType = MEDIUM;
-            } else {
-                sizeType = LARGE;
-            }
-            sizeScale = SIZE_MULTIPLIERS[sizeType];
-            // Position will be assigned later ensuring safe spawn distance from player
-            x = 0.0f;
-            y = 0.0f;
-            direction = (rand() % 2) * FISH_SPEED - (FISH_SPEED / 2.0f);
-        }
+    background.setCamera(view.cameraX, view.cameraY, view.worldHeight);
+    {
+        ProfileScope scope(PHASE_OCEAN);
+        background.drawOcean(waveOffsetAt(seconds));
     }
-    
-    // Get effective size for collision detection
-    float getCollisionRadius() const {
-        return COLLISION_RADIUS * sizeScale;
+    {
+        ProfileScope scope(PHASE_CORAL);
+        background.drawCoral(coralPhaseAt(seconds));
     }
+    stepParticles(view, seconds);
     
-    void draw() {
-        // Set color based on fish type
-        float r, g, b;
-        if (isPlayer) {
-            r = 0.2f; g = 0.4f; b = 1.0f;  // Blue player
-        } else if (isRedFish) {
-            r = 1.0f; g = 0.3f; b = 0.3f;  // Red enemy
-        } else {
-            // Yellow collectible with slight color variation based on size
-            if (sizeType == SMALL) {
-                r = 1.0f; g = 0.95f; b = 0.3f;  // Lighter yellow for small
-            } else if (sizeType == MEDIUM) {
-                r = 1.0f; g = 0.9f; b = 0.2f;   // Standard yellow
-            } else {
-                r = 1.0f; g = 0.85f; b = 0.15f; // Darker yellow for large
-            }
-        }
-        
-        // Use player's size scale if this is the player, otherwise use fish's own scale
-        float currentScale = isPlayer ? playerSizeScale : sizeScale;
-        
-        float dir = (direction < 0) ? -1.0f : 1.0f;
-        float bodyLength = FISH_SIZE * 1.8f * currentScale;
-        float bodyHeight = FISH_SIZE * 1.2f * currentScale;
+    if (!view.isGameOver) {
+        {
+            ProfileScope scope(PHASE_HUD);
+            // UI Background
+            glColor3f(0.0f, 0.0f, 0.0f);
+            glBegin(GL_QUADS);
+            // Score box
+            glVertex2f(0, 580);
+            glVertex2f(120, 580);
+            glVertex2f(120, 600);
+            glVertex2f(0, 600);
+            glEnd();
+            glBegin(GL_QUADS);
+            // Time box
+            glVertex2f(1080, 580);
+            glVertex2f(1200, 580);
+            glVertex2f(1200, 600);
+            glVertex2f(1080, 600);
+            glEnd();
         
-        // Draw fish body (oval/ellipse shape)
-        glColor3f(r, g, b);
-        glBegin(GL_POLYGON);
-        int segments = 20;
-        for (int i = 0; i <= segments; i++) {
-            float angle = PI * float(i) / float(segments);
-            float px = x + dir * (bodyLength * 0.4f * std::cos(angle));
-            float py = y + bodyHeight * 0.5f * std::sin(angle);
-            glVertex2f(px, py);
+            // Score and Time
+            const float white[3] = {1.0f, 1.0f, 1.0f};
+            const float yellow[3] = {1.0f, 1.0f, 0.0f};
+            const float aqua[3] = {0.3f, 1.0f, 0.8f};
+            const float green[3] = {0.3f, 1.0f, 0.3f};
+            drawLabel(scoreCaption, "Score:", 5, 585, white);
+            drawScore(scoreValue, 45, 585, view.score, yellow);
+            drawLabel(sizeCaption, "Size:", 5, 570, white);
+            char sizeStr[16];
+            std::snprintf(sizeStr, sizeof(sizeStr), "%.2fx", view.playerSizeScale);
+            drawLabel(sizeValue, sizeStr, 40, 570, aqua);
+            drawLabel(timeCaption, "Time:", 1100, 570, white);
+            drawScore(timeValue, 1160, 570, view.gameTime, green);
+            hudText.flush();
         }
-        glEnd();
-        
-        // Draw outline
-        glColor3f(0.0f, 0.0f, 0.0f);
-        glLineWidth(1.5f);
-        glBegin(GL_LINE_LOOP);
-        for (int i = 0; i <= segments; i++) {
-            float angle = PI * float(i) / float(segments);
-            float px = x + dir * (bodyLength * 0.4f * std::cos(angle));
-            float py = y + bodyHeight * 0.5f * std::sin(angle);
-            glVertex2f(px, py);
-        }
-        glEnd();
-        
-        // Draw tail fin (fan shape) at the back of the fish
-        float tailBaseX = x - dir * bodyLength * 0.5f;                     // back of the body
-        float tailLength = FISH_SIZE * 0.6f * currentScale;               // tail size scales with fish
-        glColor3f(r * 0.8f, g * 0.8f, b * 0.8f);
-        glBegin(GL_TRIANGLE_FAN);
-        glVertex2f(tailBaseX, y);
-        for (int i = 0; i <= 8; i++) {
-            float angle = (PI / 3.0f) * float(i) / 8.0f - (PI / 6.0f);
-            float px = tailBaseX - dir * tailLength * std::cos(angle);     // extend tail opposite to head
-            float py = y + tailLength * std::sin(angle);
-            glVertex2f(px, py);
-        }
-        glEnd();
         
-        // Draw tail outline
+        // Draw player and fish in one batch, seen through the camera
+        ProfileScope fishScope(PHASE_FISH_DRAW);
+        glPushMatrix();
+        glTranslatef(-view.cameraX, -view.cameraY, 0.0f);
+        fishRenderer.draw(view);
+        glPopMatrix();
+        drawParticles(view);
+    } else {
+        // Game Over Screen
+        // Background
         glColor3f(0.0f, 0.0f, 0.0f);
-        glLineWidth(1.0f);
-        glBegin(GL_LINE_LOOP);
-        glVertex2f(tailBaseX, y);
-        for (int i = 0; i <= 8; i++) {
-            float angle = (PI / 3.0f) * float(i) / 8.0f - (PI / 6.0f);
-            float px = tailBaseX - dir * tailLength * std::cos(angle);
-            float py = y + tailLength * std::sin(angle);
-            glVertex2f(px, py);
-        }
-        glEnd();
-        
-        // Draw top fin (dorsal fin)
-        glColor3f(r * 0.9f, g * 0.9f, b * 0.9f);
-        glBegin(GL_TRIANGLES);
-        glVertex2f(x + dir * bodyLength * 0.1f, y + bodyHeight * 0.4f);
-        glVertex2f(x + dir * bodyLength * 0.3f, y + bodyHeight * 0.6f);
-        glVertex2f(x + dir * bodyLength * 0.2f, y + bodyHeight * 0.5f);
-        glEnd();
-        
-        // Draw bottom fin (pelvic fin)
-        glBegin(GL_TRIANGLES);
-        glVertex2f(x + dir * bodyLength * 0.1f, y - bodyHeight * 0.4f);
-        glVertex2f(x + dir * bodyLength * 0.3f, y - bodyHeight * 0.6f);
-        glVertex2f(x + dir * bodyLength * 0.2f, y - bodyHeight * 0.5f);
+        glBegin(GL_QUADS);
+        glVertex2f(200, 100);
+        glVertex2f(1000, 100);
+        glVertex2f(1000, 500);
+        glVertex2f(200, 500);
         glEnd();
+        drawParticles(view);  // The final burst plays out over the box, under the text
         
-        // Draw eye (circle)
-        float eyeX = x + dir * bodyLength * 0.35f;  // Move eye towards the head/front
-        float eyeY = y + bodyHeight * 0.15f;
-        float eyeSize = FISH_SIZE * 0.15f * currentScale;
-        
-        // Eye white
-        glColor3f(1.0f, 1.0f, 1.0f);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i <= 12; i++) {
-            float angle = 2.0f * PI * float(i) / 12.0f;
-            glVertex2f(eyeX + eyeSize * std::cos(angle), eyeY + eyeSize * std::sin(angle));
+        // Messages
+        if (view.allYellowFishGone) {
+            const float title[3] = {0.3f, 1.0f, 0.3f};
+            const float caption[3] = {1.0f, 1.0f, 0.5f};
+            const float value[3] = {1.0f, 1.0f, 0.0f};
+            drawLargeText("YOU WIN!", 500, 450, title);
+            drawLargeText("Max Score: ", 500, 260, caption);
+            drawScore(finalScore, 620, 260, view.score, value);
+        } else {
+            const float title[3] = {1.0f, 0.3f, 0.3f};
+            const float caption[3] = {1.0f, 0.8f, 0.5f};
+            const float value[3] = {1.0f, 0.5f, 0.0f};
+            drawLargeText("YOU FAILED!", 500, 450, title);
+            drawLargeText("Max Score: ", 500, 260, caption);
+            drawScore(finalScore, 620, 260, view.score, value);
         }
-        glEnd();
         
-        // Eye pupil
-        glColor3f(0.0f, 0.0f, 0.0f);
-        glBegin(GL_POLYGON);
-        for (int i = 0; i <= 12; i++) {
-            float angle = 2.0f * PI * float(i) / 12.0f;
-            glVertex2f(eyeX + eyeSize * 0.6f * std::cos(angle), eyeY + eyeSize * 0.6f * std::sin(angle));
-        }
-        glEnd();
+        const float prompt[3] = {0.8f, 0.8f, 0.8f};
+        const float credits[3] = {0.6f, 0.6f, 0.6f};
+        drawLargeText("Play Again by pressing -> F2", 450, 160, prompt);
+        drawText("Created By Yehia Sharawy & Abdelrahman Sharaf", 900, 10, credits);
+        hudText.flush();
     }
     
-    void move(float mouseX = 0.0f, float mouseY = 0.0f, float prevMouseX = 0.0f) {
-        if (!isPlayer) {
-            x += direction;
-            if (x > WINDOW_WIDTH) {
-                x -= WINDOW_WIDTH;
-                y = static_cast<float>(rand() % (WINDOW_HEIGHT - 100));
-            }
-            if (x < 0) {
-                x += WINDOW_WIDTH;
-                y = static_cast<float>(rand() % (WINDOW_HEIGHT - 100));
-            }
-        } else {
-            // Update direction based on mouse movement
-            if (mouseX > prevMouseX) {
-                direction = FISH_SPEED;  // Moving right
-            } else if (mouseX < prevMouseX) {
-                direction = -FISH_SPEED;  // Moving left
-            }
-            // If mouseX == prevMouseX, keep current direction
-            
-            x = mouseX;
-            y = WINDOW_HEIGHT - mouseY;
-        }
-    }
+    glDisable(GL_BLEND);
+}
 
-    // Movement with simple behavior: flee smaller fish, chase bigger/red fish
-    void moveWithBehavior(float playerX, float playerY, float playerRadius) {
-        if (isPlayer) return;
+// Phase timings from the profiler, top centre, over the game
+void drawProfileOverlay(const WorldSnapshot& view) {
+    glEnable(GL_BLEND);
+    glColor4f(0.0f, 0.0f, 0.0f, 0.6f);
+    glBegin(GL_QUADS);
+    glVertex2f(440, 420);
+    glVertex2f(760, 420);
+    glVertex2f(760, 600);
+    glVertex2f(440, 600);
+    glEnd();
+    glDisable(GL_BLEND);
 
-        float dx = playerX - x;
-        float dy = playerY - y;
-        float dist2 = dx * dx + dy * dy;
-        float myRadius = getCollisionRadius();
+    char buffer[32];
+    const float heading[3] = {0.8f, 0.8f, 0.8f};
+    const float name[3] = {1.0f, 1.0f, 1.0f};
+    const float number[3] = {0.3f, 1.0f, 0.8f};
+    drawText("phase", 450, 586, heading);
+    drawText("min ms", 560, 586, heading);
+    drawText("avg ms", 625, 586, heading);
+    drawText("p99 ms", 690, 586, heading);
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        ProfilePhase phase = static_cast<ProfilePhase>(p);
+        const PhaseStats& stats = profiler().stats(phase);
+        int y = 572 - 12 * p;
+        drawText(Profiler::phaseName(phase), 450, y, name);
+        std::snprintf(buffer, sizeof(buffer), "%.3f", stats.minMs);
+        drawText(buffer, 560, y, number);
+        std::snprintf(buffer, sizeof(buffer), "%.3f", stats.avgMs);
+        drawText(buffer, 625, y, number);
+        std::snprintf(buffer, sizeof(buffer), "%.3f", stats.p99Ms);
+        drawText(buffer, 690, y, number);
+    }
+    char allocs[64];
+    std::snprintf(allocs, sizeof(allocs), "heap allocs/frame: render %llu  sim %llu",
+                  static_cast<unsigned long long>(renderAllocs), static_cast<unsigned long long>(simAllocs));
+    drawText(allocs, 450, 572 - 12 * PHASE_COUNT, name);
+    const FrameStats& pacing = frameScheduler.stats();
+    char rate[16] = "unlocked";
+    if (frameScheduler.targetRate() != FRAME_RATE_UNLOCKED) {
+        std::snprintf(rate, sizeof(rate), "%d Hz", frameScheduler.targetRate());
+    }
+    char frames[96];
+    std::snprintf(frames, sizeof(frames), "frames (F4) %s: p99 %.2f ms  jitter %.2f ms  skipped %ld", rate,
+                  pacing.percentileMs(0.99), pacing.averageJitterMs(), pacing.skipped);
+    drawText(frames, 450, 560 - 12 * PHASE_COUNT, name);
+    if (view.chunkCount > 0) {
+        char streaming[96];
+        std::snprintf(streaming, sizeof(streaming), "chunks awake %d/%d  fish awake %zu  asleep %zu",
+                      view.awakeChunks, view.chunkCount, view.fishCount(), view.sleepingFish);
+        drawText(streaming, 450, 548 - 12 * PHASE_COUNT, name);
+    }
+    hudText.flush();
+}
 
-        // Default drift
-        float stepX = direction;
-        float stepY = 0.0f;
+// Main Display
+void display() {
+    FrameScheduler::Clock::time_point now = FrameScheduler::Clock::now();
+    frameScheduler.beginFrame(now);
+    profiler().beginFrame();
+    const WorldSnapshot& view = simulation.view(now);
+    WorldEvent event;
+    while (simulation.pollEvent(event)) {
+        handleWorldEvent(event, view);
+    }
+    if (textEnabled) hudText.init();  // Glyph atlas, first frame only
+    renderScene(view, frameScheduler.elapsedSeconds(now));
+    if (profileOverlay) drawProfileOverlay(view);
+    {
+        ProfileScope scope(PHASE_SWAP);
+        glutSwapBuffers();
+    }
+    profiler().endFrame();
+
+    static uint64_t lastRender = 0, lastSim = 0;
+    uint64_t render = threadAllocations().allocations, sim = simulation.allocations();
+    renderAllocs = render - lastRender;
+    simAllocs = sim - lastSim;
+    lastRender = render;
+    lastSim = sim;
+}
 
-        // Flee if player is bigger and close (applies to ALL fish - yellow and red)
-        if (playerRadius > myRadius * 0.9f && dist2 < FLEE_DISTANCE * FLEE_DISTANCE) {
-            float norm = std::sqrt(dist2) + 0.001f;
-            stepX = -(dx / norm) * FISH_SPEED * FLEE_SPEED_MULT * 2.0f;
-            stepY = -(dy / norm) * FISH_SPEED * FLEE_SPEED_MULT * 2.0f;
-            direction = (stepX < 0) ? -FISH_SPEED : FISH_SPEED;
-        }
-        // Chase only if this fish is bigger (red or large) and player is smaller
-        else if ((isRedFish || sizeType == LARGE) && playerRadius < myRadius * 0.95f && dist2 < CHASE_DISTANCE * CHASE_DISTANCE) {
-            float norm = std::sqrt(dist2) + 0.001f;
-            stepX = (dx / norm) * FISH_SPEED * CHASE_SPEED_MULT * 2.0f;
-            stepY = (dy / norm) * FISH_SPEED * CHASE_SPEED_MULT * 2.0f;
-            direction = (stepX < 0) ? -FISH_SPEED : FISH_SPEED;
+// Headless mode: run whole rounds with no window or GL context and report
+// simulation throughput. The player stays parked where it spawned. With
+// --load-state the first round plays on from the loaded state.
+int runHeadless(int sessions) {
+    std::string error;
+    long totalTicks = 0;
+    int wins = 0;
+    uint64_t firstAllocs = 0;
+    AllocationStats before = threadAllocations();
+    std::clock_t start = std::clock();
+    for (int s = 0; s < sessions; ++s) {
+        if (s > 0 || !startState || !startState->restore(world, error)) world.reset();
+        while (!world.isGameOver) {
+            world.tick();
         }
+        totalTicks += world.tickCount;
+        if (world.allYellowFishGone) ++wins;
+        world.events.clear();
+        if (s == 0) firstAllocs = allocationsSince(before, threadAllocations());
+    }
+    double seconds = double(std::clock() - start) / CLOCKS_PER_SEC;
+    std::printf("sessions: %d  wins: %d  ticks: %ld  cpu: %.3fs  (%.0f ticks/s)\n",
+                sessions, wins, totalTicks, seconds,
+                seconds > 0.0 ? totalTicks / seconds : 0.0);
+    // Restarts and ticks should reuse the first round's storage
+    std::printf("heap allocations: first round %llu  later rounds %llu\n",
+                static_cast<unsigned long long>(firstAllocs),
+                static_cast<unsigned long long>(allocationsSince(before, threadAllocations()) - firstAllocs));
+    return 0;
+}
 
-        x += stepX;
-        y += stepY;
+// Batch mode: play `sessions` rounds at every point of the sweep grid with a
+// bot at the controls, across the job pool, and write per-point statistics
+// as CSV (to stdout unless a path is given)
+int runBatch(BatchConfig& config, JobSystem* jobs, const char* csvPath, const char* roundsPath) {
+    config.level = world.level;
+    BatchRunner batch(jobs);
+    std::string error;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (!batch.run(config, error)) {
+        std::fprintf(stderr, "batch: %s\n", error.c_str());
+        return 1;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    long ticks = batch.totalTicks();
+    std::fprintf(stderr, "batch: %zu points x %d rounds, %s bot, %u threads: %ld ticks in %.3fs (%.0f ticks/s)\n",
+                 batch.pointCount(), batch.sessions(), botName(config.bot), jobs ? jobs->threadCount() : 1u,
+                 ticks, elapsed.count(), elapsed.count() > 0.0 ? ticks / elapsed.count() : 0.0);
+
+    std::FILE* csv = csvPath ? std::fopen(csvPath, "w") : stdout;
+    if (!csv) {
+        std::fprintf(stderr, "batch: cannot write %s\n", csvPath);
+        return 1;
+    }
+    batch.writeSummaryCsv(csv);
+    if (csv != stdout) std::fclose(csv);
+    if (roundsPath) {
+        std::FILE* rounds = std::fopen(roundsPath, "w");
+        if (!rounds) {
+            std::fprintf(stderr, "batch: cannot write %s\n", roundsPath);
+            return 1;
+        }
+        batch.writeRoundsCsv(rounds);
+        std::fclose(rounds);
+    }
+    return 0;
+}
 
-        // Wrap horizontally
-        if (x > WINDOW_WIDTH) {
-            x -= WINDOW_WIDTH;
-            y = static_cast<float>(rand() % (WINDOW_HEIGHT - 100));
+// Offscreen mode: render frames into an EGL pbuffer (no window, no GPU
+// needed), one simulation tick per frame, and report render times. HUD text
+// is skipped because GLUT bitmap fonts need a GLUT window. Frames go as fast
+// as they render unless paced is set, which holds them to the scheduler's
+// rate and reports how well it kept time. Animation advances one tick per
+// frame either way, so a seed always gives the same images.
+int runOffscreen(int frames, const char* dumpDir, bool verbose, bool profile, bool paced) {
+    OffscreenContext context;
+    if (!context.create(WINDOW_WIDTH, WINDOW_HEIGHT)) {
+        std::fprintf(stderr, "offscreen: %s\n", context.error().c_str());
+        return 1;
+    }
+    textEnabled = false;
+    initGame();
+    std::printf("renderer: %s | %s\n", glGetString(GL_RENDERER), glGetString(GL_VERSION));
+
+    WorldSnapshot view;
+    std::vector<double> frameMs;
+    std::vector<unsigned char> pixels;
+    long fishDrawCalls = 0;
+    double fishVertices = 0.0;
+    double particlePoints = 0.0;
+    for (int frame = 0; frame < frames; ++frame) {
+        if (paced) {
+            while (!frameScheduler.waitForFrame(std::chrono::milliseconds(4))) {}
+            frameScheduler.beginFrame(FrameScheduler::Clock::now());
         }
-        if (x < 0) {
-            x += WINDOW_WIDTH;
-            y = static_cast<float>(rand() % (WINDOW_HEIGHT - 100));
+        profiler().beginFrame();
+        world.tick();
+        view.capture(world);
+        for (size_t i = 0; i < world.events.size(); ++i) {
+            handleWorldEvent(world.events[i], view);
         }
+        world.events.clear();
 
-        // Clamp vertical movement to stay in ocean
-        if (y < 40) y = 40;
-        if (y > OCEAN_HEIGHT - 30) y = OCEAN_HEIGHT - 30;
-    }
-};
-
-// Game Objects
-std::vector<Fish> fishArray;
-Fish player(true);
-
-// Ensure fish spawn away from player to avoid unfair instant collisions
-void randomizeFishPositionAway(Fish& f) {
-    if (f.isPlayer) return;
-    int attempts = 0;
-    float safeDist2 = SAFE_SPAWN_DISTANCE * SAFE_SPAWN_DISTANCE;
-    while (attempts < 50) {
-        f.x = static_cast<float>(rand() % (WINDOW_WIDTH - 100));
-        f.y = static_cast<float>(rand() % (WINDOW_HEIGHT - 100));
-        float dx = f.x - player.x;
-        float dy = f.y - player.y;
-        if (dx * dx + dy * dy > safeDist2) break;
-        attempts++;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        renderScene(view, frame * static_cast<double>(SIM_DT));
+        {
+            ProfileScope scope(PHASE_SWAP);  // No swap offscreen; wait for the GPU instead
+            glFinish();
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        profiler().endFrame();
+        frameMs.push_back(elapsed.count());
+        fishDrawCalls += fishRenderer.stats().drawCalls;
+        fishVertices += fishRenderer.stats().vertices;
+        particlePoints += particleRenderer.drawn();
+        if (verbose) std::printf("frame %d: %.3f ms\n", frame, elapsed.count());
+
+        if (dumpDir) {
+            char path[512];
+            std::snprintf(path, sizeof(path), "%s/frame_%05d.ppm", dumpDir, frame);
+            context.readPixels(pixels);
+            if (!writePPM(path, WINDOW_WIDTH, WINDOW_HEIGHT, pixels)) {
+                std::fprintf(stderr, "offscreen: could not write %s\n", path);
+                return 1;
+            }
+        }
     }
-}
 
-// Collision Detection - uses size-based radii
-bool checkCollision(const Fish& a, const Fish& b) {
-    float dx = a.x - b.x;
-    float dy = a.y - b.y;
-    float distanceSquared = dx * dx + dy * dy;
-    
-    float radiusA = a.isPlayer ? (COLLISION_RADIUS * playerSizeScale) : a.getCollisionRadius();
-    float radiusB = b.isPlayer ? (COLLISION_RADIUS * playerSizeScale) : b.getCollisionRadius();
-    float combinedRadius = radiusA + radiusB;
-    float collisionDistance = combinedRadius * combinedRadius;
-    
-    return distanceSquared < collisionDistance;
+    // The first frame pays for shader compilation and cache building; keep it
+    // out of the steady-state numbers
+    double firstMs = frameMs.front();
+    std::vector<double> sorted(frameMs.begin() + (frames > 1 ? 1 : 0), frameMs.end());
+    std::sort(sorted.begin(), sorted.end());
+    double total = 0.0;
+    for (size_t i = 0; i < sorted.size(); ++i) total += sorted[i];
+    size_t p99 = std::min(sorted.size() - 1, sorted.size() * 99 / 100);
+    std::printf("frames: %d  first %.3f ms  steady avg %.3f  min %.3f  p99 %.3f  max %.3f  fish draw calls/frame %.1f\n",
+                frames, firstMs, total / sorted.size(), sorted.front(), sorted[p99], sorted.back(),
+                double(fishDrawCalls) / frames);
+    const FishMesh& mesh = fishRenderer.lastMesh();
+    std::printf("fish vertices/frame %.0f  last frame lod full %d  medium %d  small %d  impostor %d  culled %zu\n",
+                fishVertices / frames, mesh.lodFish[FISH_LOD_FULL], mesh.lodFish[FISH_LOD_MEDIUM],
+                mesh.lodFish[FISH_LOD_SMALL], mesh.lodFish[FISH_LOD_IMPOSTOR], mesh.culledFish);
+    std::printf("particles live %zu (pool %zu)  points/frame %.0f\n", particles.live(), particles.capacity(),
+                particlePoints / frames);
+    if (profile) profiler().report(stdout);
+    if (paced) frameScheduler.report(stdout);
+    return 0;
 }
 
-// Check if player can eat the other fish (player must be larger)
-bool canEatFish(const Fish& player, const Fish& other) {
-    float playerRadius = COLLISION_RADIUS * playerSizeScale;
-    float otherRadius = other.getCollisionRadius();
-    return playerRadius >= otherRadius * 0.95f;  // Slight forgiveness to reduce unfair losses
+// Replay mode: rerun a recorded session without a window, as fast as the
+// simulation goes, and report how it ended
+int runReplay(const char* path, int repeats) {
+    InputReplay replay;
+    if (!replay.load(path)) {
+        std::fprintf(stderr, "replay: %s\n", replay.error().c_str());
+        return 1;
+    }
+    long ticks = 0;
+    std::clock_t start = std::clock();
+    for (int r = 0; r < repeats; ++r) {
+        ticks += replayInput(world, replay);
+    }
+    double seconds = double(std::clock() - start) / CLOCKS_PER_SEC;
+    std::printf("seed: %llu  events: %zu  round seed: %llu  score: %d  size: %.2fx  time left: %d  %s\n",
+                static_cast<unsigned long long>(replay.masterSeed), replay.events.size(),
+                static_cast<unsigned long long>(world.roundSeed), world.score,
+                world.playerSizeScale, world.gameTime,
+                !world.isGameOver ? "in progress" : world.allYellowFishGone ? "won" : "lost");
+    std::printf("replays: %d  ticks: %ld  cpu: %.3fs  (%.0f ticks/s)\n", repeats, ticks, seconds,
+                seconds > 0.0 ? ticks / seconds : 0.0);
+    return 0;
 }
 
-// Initialization
-void initGame() {
-    glClearColor(0.07f, 0.01f, 0.75f, 1.0f);
-    playerSizeScale = INITIAL_PLAYER_SIZE;  // Reset player size
-    prevMouseX = WINDOW_WIDTH / 2.0f;  // Initialize previous mouse position
-    fishArray.clear();
-    for (int i = 0; i < NUM_FISH; ++i) {
-        Fish f;
-        randomizeFishPositionAway(f);
-        fishArray.push_back(f);
+// Compile a level to its binary form, then load it back and report how long
+// loading takes
+int compileLevel(const char* inPath, const char* outPath) {
+    Level level;
+    std::string error;
+    if (!level.load(inPath, error) || !level.writeBinary(outPath, error)) {
+        std::fprintf(stderr, "level: %s\n", error.c_str());
+        return 1;
     }
-    glMatrixMode(GL_PROJECTION);
-    gluOrtho2D(0.0, WINDOW_WIDTH, 0.0, WINDOW_HEIGHT);
-}
 
-// Input Handlers
-void mouseMove(int x, int y) {
-    float mouseX = static_cast<float>(x);
-    float mouseY = static_cast<float>(y);
-    player.move(mouseX, mouseY, prevMouseX);
-    prevMouseX = mouseX;  // Update previous mouse position
+    const int loads = 100;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < loads; ++i) {
+        Level compiled;
+        if (!compiled.load(outPath, error)) {
+            std::fprintf(stderr, "level: %s\n", error.c_str());
+            return 1;
+        }
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    std::printf("level: %s  species: %d  placed fish: %zu  load: %.3f ms\n", level.rules.name,
+                level.rules.speciesCount, level.placedCount(), elapsed.count() / loads);
+    return 0;
 }
 
-void keyboard(int key, int x, int y) {
-    if (key == GLUT_KEY_F2) {
-        isGameOver = false;
-        gameTime = INITIAL_TIME;
-        score = 0;
-        allYellowFishGone = false;
-        soundPlayed = false;
-        playerSizeScale = INITIAL_PLAYER_SIZE;  // Reset player size
-        prevMouseX = WINDOW_WIDTH / 2.0f;  // Reset previous mouse position
-        fishArray.clear();
-        for (int i = 0; i < NUM_FISH; ++i) {
-            Fish f;
-            randomizeFishPositionAway(f);
-            fishArray.push_back(f);
+#ifndef _WIN32
+// Write the newest checkpoint for the tools to load, then crash as before.
+// Only async-signal-safe calls from here on.
+void dumpStateOnCrash(int sig) {
+    const WorldState* state = simulation.stateHistory().newestCheckpoint();
+    int fd = state ? open(crashDumpPath, O_WRONLY | O_CREAT | O_TRUNC, 0644) : -1;
+    if (fd >= 0) {
+        const unsigned char* data = state->data();
+        size_t left = state->byteCount();
+        while (left > 0) {
+            ssize_t written = write(fd, data, left);
+            if (written <= 0) break;
+            data += written;
+            left -= static_cast<size_t>(written);
         }
+        close(fd);
+        static const char note[] = "crashed: wrote the last checkpoint for --load-state\n";
+        if (left == 0 && write(STDERR_FILENO, note, sizeof(note) - 1) < 0) {}
     }
-    glutPostRedisplay();
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
 }
 
-// Timers
-void animationTimer(int value) {
-    glutPostRedisplay();
-    glutTimerFunc(20, animationTimer, 0);
+void installCrashDump() {
+    const int signals[] = {SIGSEGV, SIGABRT, SIGFPE, SIGILL, SIGBUS};
+    for (int sig : signals) std::signal(sig, dumpStateOnCrash);
 }
+#else
+void installCrashDump() {}
+#endif
 
-void gameTimer(int value) {
-    if (!isGameOver && gameTime > 0) {
-        --gameTime;
-        if (gameTime == 0) {
-            isGameOver = true;
-            soundPlayed = false;
-        }
-    }
-    glutPostRedisplay();
-    glutTimerFunc(1000, gameTimer, 0);
+// Runs at exit (glutMainLoop never returns): stop the simulation before
+// anything it uses is torn down, then finish the recording
+void shutdown() {
+    simulation.stop();
+    recorder.close(world.tickCount);
+    if (frameStatsAtExit) frameScheduler.report(stdout);
 }
 
-// Main Display
-void display() {
-    glClear(GL_COLOR_BUFFER_BIT);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    
-    coralPhase += CORAL_SWAY_SPEED;
-    drawOcean();
-    drawCoral();
-    
-    if (!isGameOver) {
-        // UI Background
-        glColor3f(0.0f, 0.0f, 0.0f);
-        glBegin(GL_QUADS);
-        // Score box
-        glVertex2f(0, 580);
-        glVertex2f(120, 580);
-        glVertex2f(120, 600);
-        glVertex2f(0, 600);
-        glEnd();
-        glBegin(GL_QUADS);
-        // Time box
-        glVertex2f(1080, 580);
-        glVertex2f(1200, 580);
-        glVertex2f(1200, 600);
-        glVertex2f(1080, 600);
-        glEnd();
-        
-        // Score and Time
-        glColor3f(1.0f, 1.0f, 1.0f);
-        drawText("Score:", 5, 585);
-        glColor3f(1.0f, 1.0f, 0.0f);
-        drawScore(45, 585, score);
-        glColor3f(1.0f, 1.0f, 1.0f);
-        drawText("Size:", 5, 570);
-        glColor3f(0.3f, 1.0f, 0.8f);
-        char sizeStr[16];
-        std::snprintf(sizeStr, sizeof(sizeStr), "%.2fx", playerSizeScale);
-        glRasterPos2d(40, 570);
-        for (int i = 0; sizeStr[i] != '\0'; i++)
-            glutBitmapCharacter(GLUT_BITMAP_HELVETICA_12, sizeStr[i]);
-        glColor3f(1.0f, 1.0f, 1.0f);
-        drawText("Time:", 1100, 570);
-        glColor3f(0.3f, 1.0f, 0.3f);
-        drawScore(1160, 570, gameTime);
-        
-        // Draw player
-        player.draw();
-        
-        // Update and draw fish
-        float playerRadius = COLLISION_RADIUS * playerSizeScale;
-        for (int i = 0; i < static_cast<int>(fishArray.size()); ++i) {
-            fishArray[i].moveWithBehavior(player.x, player.y, playerRadius);
-            if (!fishArray[i].isPlayer && checkCollision(player, fishArray[i])) {
-                if (fishArray[i].isRedFish) {
-                    // Red fish: Game Over only if player is smaller or equal
-                    if (!canEatFish(player, fishArray[i])) {
-                        playSound(1);
-                        isGameOver = true;
-                        soundPlayed = false;
-                        break;  // Exit loop immediately
-                    } else {
-                        // Player is big enough to eat red fish!
-                        score += 3;  // Bonus points for eating red fish
-                        playSound(0);
-                        // Player grows when eating larger fish
-                        if (playerSizeScale < MAX_PLAYER_SIZE) {
-                            playerSizeScale += GROWTH_INCREMENT * 2.0f;
-                            if (playerSizeScale > MAX_PLAYER_SIZE) {
-                                playerSizeScale = MAX_PLAYER_SIZE;
-                            }
-                        }
-                        fishArray.erase(fishArray.begin() + i);
-                        --i;
-                    }
-                } else {
-                    // Yellow fish: Check if player can eat it
-                    if (canEatFish(player, fishArray[i])) {
-                        // Collect points and remove fish
-                        int points = 1;
-                        if (fishArray[i].sizeType == MEDIUM) points = 2;
-                        else if (fishArray[i].sizeType == LARGE) points = 3;
-                        
-                        score += points;
-                        playSound(0);
-                        
-                        // Player grows when eating fish
-                        if (playerSizeScale < MAX_PLAYER_SIZE) {
-                            playerSizeScale += GROWTH_INCREMENT;
-                            if (playerSizeScale > MAX_PLAYER_SIZE) {
-                                playerSizeScale = MAX_PLAYER_SIZE;
-                            }
-                        }
-                        
-                        fishArray.erase(fishArray.begin() + i);
-                        --i;  // Adjust index after erasing
-                    } else {
-                        // Player is too small - game over
-                        playSound(1);
-                        isGameOver = true;
-                        soundPlayed = false;
-                        break;
-                    }
-                }
-            } else {
-                fishArray[i].draw();
+// Main
+int main(int argc, char *argv[]) {
+    uint64_t seed = static_cast<uint64_t>(std::time(nullptr));
+    int headlessSessions = 0;
+    int offscreenFrames = 0;
+    const char* dumpDir = 0;
+    const char* recordPath = 0;
+    const char* replayPath = 0;
+    int replayRepeats = 1;
+    const char* tracePath = 0;
+    int traceFrames = 120;
+    const char* levelPath = 0;
+    const char* statePath = 0;
+    int threads = 0;  // 0: one per hardware thread
+    bool verbose = false;
+    bool profile = false;
+    int fps = -1;  // Not given: 60 in a window, unpaced offscreen
+    bool vsync = false;
+    BatchConfig batch;
+    batch.sessions = 0;  // Set by --batch
+    const char* csvPath = 0;
+    const char* roundsPath = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc && argv[i + 1][0] != '-';
+        if (arg == "--headless") {
+            headlessSessions = hasValue ? std::atoi(argv[++i]) : 1000;
+        } else if (arg == "--offscreen") {
+            offscreenFrames = hasValue ? std::atoi(argv[++i]) : 300;
+        } else if (arg == "--dump" && hasValue) {
+            dumpDir = argv[++i];
+        } else if (arg == "--seed" && hasValue) {
+            seed = std::strtoull(argv[++i], 0, 10);
+        } else if (arg == "--record" && hasValue) {
+            recordPath = argv[++i];
+        } else if (arg == "--replay" && hasValue) {
+            replayPath = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') replayRepeats = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--verbose") {
+            verbose = true;
+        } else if (arg == "--threads" && hasValue) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--profile") {
+            profile = true;
+        } else if (arg == "--trace" && hasValue) {
+            tracePath = argv[++i];
+            if (i + 1 < argc && argv[i + 1][0] != '-') traceFrames = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--fps" && hasValue) {
+            fps = std::atoi(argv[++i]);
+        } else if (arg == "--vsync") {
+            vsync = true;
+        } else if (arg == "--frame-stats") {
+            frameStatsAtExit = true;
+        } else if (arg == "--batch") {
+            batch.sessions = hasValue ? std::atoi(argv[++i]) : 1000;
+        } else if (arg == "--bot" && hasValue) {
+            if (!parseBot(argv[++i], batch.bot)) {
+                std::fprintf(stderr, "bot: expected parked, scripted or greedy, not %s\n", argv[i]);
+                return 1;
             }
-        }
-        
-        // Check win condition - all fish (yellow and red) must be collected
-        bool allFishGone = true;
-        for (const auto& fish : fishArray) {
-            if (!fish.isPlayer) {  // Check if any non-player fish exists
-                allFishGone = false;
-                break;
+        } else if (arg == "--sweep" && i + 1 < argc) {
+            SweepAxis axis;
+            std::string error;
+            if (!parseSweepAxis(argv[++i], axis, error)) {
+                std::fprintf(stderr, "%s\n", error.c_str());
+                return 1;
             }
+            batch.axes.push_back(axis);
+        } else if (arg == "--csv" && hasValue) {
+            csvPath = argv[++i];
+        } else if (arg == "--rounds-csv" && hasValue) {
+            roundsPath = argv[++i];
+        } else if (arg == "--level" && hasValue) {
+            levelPath = argv[++i];
+        } else if (arg == "--load-state" && hasValue) {
+            statePath = argv[++i];
+        } else if (arg == "--particles" && hasValue) {
+            particles.setAmbientCount(std::max(0, std::atoi(argv[++i])));
+        } else if (arg == "--crash-dump" && hasValue) {
+            crashDumpPath = argv[++i];
+        } else if (arg == "--compile-level" && i + 2 < argc) {
+            return compileLevel(argv[i + 1], argv[i + 2]);
         }
-        // End game immediately if all fish are collected
-        if (allFishGone) {
-            allYellowFishGone = true;  // Set to true for win condition
-            isGameOver = true;
-            soundPlayed = false;
+    }
+
+    // Every mode plays the same level; the window also reloads it on change
+    std::unique_ptr<LevelWatcher> levelWatcher;
+    if (levelPath) {
+        levelWatcher.reset(new LevelWatcher(levelPath));
+        std::string error;
+        std::shared_ptr<const Level> level = levelWatcher->load(error);
+        if (!level) {
+            std::fprintf(stderr, "level: %s\n", error.c_str());
+            return 1;
         }
-    } else {
-        // Game Over Screen
-        if (!soundPlayed) {
-            playSound(allYellowFishGone ? 3 : 2);
-            soundPlayed = true;
+        world.setLevel(level);
+    }
+
+    // A loaded state plays on under the rules it was saved with; a level
+    // given as well must have the same rules, and its placed fish come back
+    // on restart
+    WorldState loadedState;
+    if (statePath) {
+        std::string error;
+        if (!loadedState.load(statePath, error)) {
+            std::fprintf(stderr, "state: %s\n", error.c_str());
+            return 1;
         }
-        
-        // Background
-        glColor3f(0.0f, 0.0f, 0.0f);
-        glBegin(GL_QUADS);
-        glVertex2f(200, 100);
-        glVertex2f(1000, 100);
-        glVertex2f(1000, 500);
-        glVertex2f(200, 500);
-        glEnd();
-        
-        // Messages
-        if (allYellowFishGone) {
-            glColor3f(0.3f, 1.0f, 0.3f);
-            drawLargeText("YOU WIN!", 500, 450);
-            glColor3f(1.0f, 1.0f, 0.5f);
-            drawLargeText("Max Score: ", 500, 260);
-            glColor3f(1.0f, 1.0f, 0.0f);
-            drawScore(620, 260, score);
-        } else {
-            glColor3f(1.0f, 0.3f, 0.3f);
-            drawLargeText("YOU FAILED!", 500, 450);
-            glColor3f(1.0f, 0.8f, 0.5f);
-            drawLargeText("Max Score: ", 500, 260);
-            glColor3f(1.0f, 0.5f, 0.0f);
-            drawScore(620, 260, score);
+        if (recordPath) {
+            std::fprintf(stderr, "record: recordings start from a seed, not from a loaded state\n");
+            return 1;
+        }
+        if (batch.sessions > 0 || replayPath) {
+            std::fprintf(stderr, "state: --batch and --replay play rounds from a seed, not from a loaded state\n");
+            return 1;
+        }
+        if (!levelPath) {
+            std::shared_ptr<const Level> level = defaultLevel()->withRules(loadedState.rules(), error);
+            if (!level) {
+                std::fprintf(stderr, "state: %s: %s\n", statePath, error.c_str());
+                return 1;
+            }
+            world.setLevel(level);
+        }
+        if (!loadedState.restore(world, error)) {
+            std::fprintf(stderr, "state: %s: %s\n", statePath, error.c_str());
+            return 1;
+        }
+        WorldStateHeader header = loadedState.header();
+        std::printf("state: %s (%s)  round seed: %llu  tick: %lld  score: %d  time left: %d  fish: %u awake, %u asleep\n",
+                    statePath, world.level->rules.name, static_cast<unsigned long long>(header.roundSeed),
+                    static_cast<long long>(header.tickCount), header.score, header.gameTime, header.fishCount,
+                    header.sleepingCount);
+        startState = &loadedState;
+    }
+
+    // Only large oceans use the pool; the standard 20-fish round stays serial
+    std::unique_ptr<JobSystem> jobPool;
+    if (threads != 1) {
+        jobPool.reset(new JobSystem(threads > 1 ? threads - 1 : 0));
+        world.jobs = jobPool.get();
+    }
+
+    if (replayPath) {
+        return runReplay(replayPath, replayRepeats);
+    }
+    world.seedRounds(seed);
+    profiler().setEnabled(profile);
+    if (tracePath && !profiler().startTrace(tracePath, traceFrames)) {
+        std::fprintf(stderr, "trace: cannot write %s\n", tracePath);
+        return 1;
+    }
+    if (headlessSessions > 0) {
+        return runHeadless(headlessSessions);
+    }
+    if (batch.sessions > 0) {
+        batch.seed = seed;
+        return runBatch(batch, jobPool.get(), csvPath, roundsPath);
+    }
+    if (fps >= 0) frameScheduler.setTargetRate(fps);
+    if (offscreenFrames > 0) {
+        return runOffscreen(offscreenFrames, dumpDir, verbose, profile, fps >= 0);
+    }
+
+    std::printf("seed: %llu\n", static_cast<unsigned long long>(seed));
+    profileOverlay = profile;
+    if (recordPath) {
+        if (!recorder.open(recordPath, seed)) {
+            std::fprintf(stderr, "record: cannot write %s\n", recordPath);
+            return 1;
         }
-        
-        glColor3f(0.8f, 0.8f, 0.8f);
-        drawLargeText("Play Again by pressing -> F2", 450, 160);
-        glColor3f(0.6f, 0.6f, 0.6f);
-        drawText("Created By Yehia Sharawy & Abdelrahman Sharaf", 900, 10);
     }
-    
-    glDisable(GL_BLEND);
-    glutSwapBuffers();
-}
 
-// Main
-int main(int argc, char *argv[]) {
-    std::srand(static_cast<unsigned int>(std::time(nullptr)));
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_RGB | GLUT_DOUBLE);
     glutInitWindowSize(WINDOW_WIDTH, WINDOW_HEIGHT);
     glutInitWindowPosition(250, 200);
     glutCreateWindow("Fish Game");
     initGame();
+    if (vsync && !setSwapInterval(1)) std::fprintf(stderr, "vsync: not supported by this driver\n");
     glutPassiveMotionFunc(mouseMove);
     glutSpecialFunc(keyboard);
-    glutTimerFunc(0, animationTimer, 0);
-    glutTimerFunc(0, gameTimer, 0);
+    glutIdleFunc(idle);
     glutDisplayFunc(display);
+    profiler().nameThread("render");
+    simulation.start(world, recordPath ? &recorder : 0, levelWatcher.get());
+    installCrashDump();
+    std::atexit(shutdown);
     glutMainLoop();
+    simulation.stop();  // In case the loop returns, before main's locals go
     return 0;
 }
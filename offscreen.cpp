@@ -0,0 +1,129 @@
+//
+//  offscreen.cpp
+//  Fish-Fillet-Project
+//
+
+#include "offscreen.h"
+#include <cstdio>
+#include <cstring>
+
+#if defined(__linux__)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GL/gl.h>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+OffscreenContext::OffscreenContext()
+    : display(EGL_NO_DISPLAY), surface(EGL_NO_SURFACE), context(EGL_NO_CONTEXT),
+      surfaceWidth(0), surfaceHeight(0) {}
+
+OffscreenContext::~OffscreenContext() {
+    destroy();
+}
+
+bool OffscreenContext::create(int width, int height) {
+    destroy();
+
+    PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+        reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+    EGLDisplay dpy = getPlatformDisplay
+        ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, 0)
+        : EGL_NO_DISPLAY;
+    if (dpy == EGL_NO_DISPLAY || !eglInitialize(dpy, 0, 0)) {
+        lastError = "no EGL surfaceless display (needs Mesa)";
+        return false;
+    }
+    display = dpy;
+
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_NONE
+    };
+    EGLConfig config;
+    EGLint count = 0;
+    if (!eglChooseConfig(dpy, configAttribs, &config, 1, &count) || count == 0) {
+        lastError = "no pbuffer-capable desktop GL config";
+        destroy();
+        return false;
+    }
+
+    const EGLint surfaceAttribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+    surface = eglCreatePbufferSurface(dpy, config, surfaceAttribs);
+    if (surface == EGL_NO_SURFACE || !eglBindAPI(EGL_OPENGL_API)) {
+        lastError = "could not create a pbuffer surface";
+        destroy();
+        return false;
+    }
+
+    // Legacy (compatibility) context: the game uses fixed-function GL
+    context = eglCreateContext(dpy, config, EGL_NO_CONTEXT, 0);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(dpy, surface, surface, context)) {
+        lastError = "could not create a GL context";
+        destroy();
+        return false;
+    }
+
+    surfaceWidth = width;
+    surfaceHeight = height;
+    glViewport(0, 0, width, height);
+    return true;
+}
+
+void OffscreenContext::destroy() {
+    if (display == EGL_NO_DISPLAY) return;
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+    if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+    eglTerminate(display);
+    display = EGL_NO_DISPLAY;
+    surface = EGL_NO_SURFACE;
+    context = EGL_NO_CONTEXT;
+}
+
+void OffscreenContext::readPixels(std::vector<unsigned char>& rgb) const {
+    size_t row = static_cast<size_t>(surfaceWidth) * 3;
+    std::vector<unsigned char> flipped(row * surfaceHeight);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, surfaceWidth, surfaceHeight, GL_RGB, GL_UNSIGNED_BYTE, &flipped[0]);
+
+    // GL reads bottom-up; images are stored top-down
+    rgb.resize(flipped.size());
+    for (int y = 0; y < surfaceHeight; ++y) {
+        std::memcpy(&rgb[y * row], &flipped[(surfaceHeight - 1 - y) * row], row);
+    }
+}
+
+#else
+
+OffscreenContext::OffscreenContext()
+    : display(0), surface(0), context(0), surfaceWidth(0), surfaceHeight(0) {}
+
+OffscreenContext::~OffscreenContext() {}
+
+bool OffscreenContext::create(int, int) {
+    lastError = "offscreen rendering needs EGL (Linux/Mesa)";
+    return false;
+}
+
+void OffscreenContext::destroy() {}
+
+void OffscreenContext::readPixels(std::vector<unsigned char>& rgb) const {
+    rgb.clear();
+}
+
+#endif
+
+bool writePPM(const char* path, int width, int height, const std::vector<unsigned char>& rgb) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) return false;
+    std::fprintf(f, "P6\n%d %d\n255\n", width, height);
+    size_t bytes = static_cast<size_t>(width) * height * 3;
+    bool ok = rgb.size() >= bytes && std::fwrite(&rgb[0], 1, bytes, f) == bytes;
+    std::fclose(f);
+    return ok;
+}
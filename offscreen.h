@@ -0,0 +1,46 @@
+//
+//  offscreen.h
+//  Fish-Fillet-Project
+//
+//  Window-less GL context for benchmarking and golden-image checks. On
+//  Linux this is an EGL pbuffer on Mesa's surfaceless platform, which runs
+//  on llvmpipe with no GPU and no X server. Other platforms get a stub that
+//  reports the mode as unavailable.
+//
+
+#ifndef OFFSCREEN_H
+#define OFFSCREEN_H
+
+#include <string>
+#include <vector>
+
+class OffscreenContext {
+public:
+    OffscreenContext();
+    ~OffscreenContext();
+
+    // Create a width x height RGB pbuffer and make it current
+    bool create(int width, int height);
+    void destroy();
+
+    // Why create() failed, if it did
+    const std::string& error() const { return lastError; }
+
+    // Finish rendering and read the colour buffer, top row first
+    void readPixels(std::vector<unsigned char>& rgb) const;
+
+    int width() const { return surfaceWidth; }
+    int height() const { return surfaceHeight; }
+
+private:
+    void* display;
+    void* surface;
+    void* context;
+    int surfaceWidth, surfaceHeight;
+    std::string lastError;
+};
+
+// Binary PPM (P6), rows top to bottom
+bool writePPM(const char* path, int width, int height, const std::vector<unsigned char>& rgb);
+
+#endif // OFFSCREEN_H
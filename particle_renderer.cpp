@@ -0,0 +1,40 @@
+//
+//  particle_renderer.cpp
+//  Fish-Fillet-Project
+//
+
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#include <OpenGL/gl.h>
+#else
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/gl.h>
+#endif
+#include "particle_renderer.h"
+
+void ParticleRenderer::draw(ParticleSystem& particles, float viewX, float viewY, float viewWidth,
+                            float viewHeight) {
+    particles.buildPoints(viewX, viewY, viewWidth, viewHeight);
+    lastDrawn = particles.vertexCount();
+    if (lastDrawn == 0) return;
+
+    const ParticleVertex* vertices = particles.pointVertices();
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(ParticleVertex), &vertices[0].x);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(ParticleVertex), &vertices[0].r);
+    for (int side = 1; side <= PARTICLE_MAX_SIDE; ++side) {
+        if (particles.sideCount(side) == 0) continue;
+        glPointSize(static_cast<GLfloat>(side));
+        glDrawArrays(GL_POINTS, static_cast<GLint>(particles.sideFirst(side)),
+                     static_cast<GLsizei>(particles.sideCount(side)));
+    }
+    glPointSize(1.0f);
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+    glDisable(GL_BLEND);
+}
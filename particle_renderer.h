@@ -0,0 +1,32 @@
+//
+//  particle_renderer.h
+//  Fish-Fillet-Project
+//
+//  Draws every live particle in view as square points from the one array
+//  ParticleSystem::buildPoints() lays out, through GL 1.1 client-side vertex
+//  arrays like the fish: one glDrawArrays per point size in use, at most
+//  PARTICLE_MAX_SIDE.
+//
+
+#ifndef PARTICLE_RENDERER_H
+#define PARTICLE_RENDERER_H
+
+#include "particles.h"
+
+class ParticleRenderer {
+public:
+    ParticleRenderer() : lastDrawn(0) {}
+
+    // Particles are in ocean coordinates; the caller moves the view to the
+    // camera. Blends them in for their fading alpha and leaves blending off,
+    // as the background does.
+    void draw(ParticleSystem& particles, float viewX, float viewY, float viewWidth, float viewHeight);
+
+    // Particles drawn last frame
+    size_t drawn() const { return lastDrawn; }
+
+private:
+    size_t lastDrawn;
+};
+
+#endif // PARTICLE_RENDERER_H
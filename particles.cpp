@@ -0,0 +1,167 @@
+//
+//  particles.cpp
+//  Fish-Fillet-Project
+//
+
+#include "particles.h"
+#include "game_config.h"
+#include <algorithm>
+#include <cmath>
+
+#if !defined(FISH_KERNEL_SCALAR) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define PARTICLES_SSE2 1
+#endif
+
+const float BUBBLE_RISE = 60.0f;        // px/s^2 of buoyancy
+const float SCALE_SINK = -90.0f;        // px/s^2 of sinking
+const float PLANKTON_SECONDS = 8.0f;    // Lifetime of one plankton
+
+static uint32_t rgba(unsigned r, unsigned g, unsigned b, unsigned a) {
+    return r | (g << 8) | (b << 16) | (a << 24);
+}
+
+ParticleSystem::ParticleSystem(size_t capacity, uint64_t seed)
+    : vertexTotal(0), head(0), used(0), liveCount(0), ambientCount(AMBIENT_PLANKTON), planktonDue(0.0f), rng(seed) {
+    capacity = (std::max(capacity, static_cast<size_t>(4)) + 3) / 4 * 4;
+    x.assign(capacity, 0.0f);
+    y.assign(capacity, 0.0f);
+    vx.assign(capacity, 0.0f);
+    vy.assign(capacity, 0.0f);
+    ay.assign(capacity, 0.0f);
+    life.assign(capacity, 0.0f);
+    side.assign(capacity, 1);
+    color.assign(capacity, 0);
+    vertices.resize(capacity);
+    std::fill(sideStart, sideStart + PARTICLE_MAX_SIDE + 2, 0);
+}
+
+void ParticleSystem::clear() {
+    std::fill(life.begin(), life.end(), 0.0f);
+    head = used = liveCount = 0;
+    planktonDue = 0.0f;
+    vertexTotal = 0;
+    std::fill(sideStart, sideStart + PARTICLE_MAX_SIDE + 2, 0);
+}
+
+float ParticleSystem::uniform(float lo, float hi) {
+    return lo + (hi - lo) * (rng.next() * (1.0f / 4294967296.0f));
+}
+
+void ParticleSystem::emit(float px, float py, float pvx, float pvy, float pay, float seconds, int pointSide,
+                          uint32_t rgbaColor) {
+    size_t i = head;
+    x[i] = px;
+    y[i] = py;
+    vx[i] = pvx;
+    vy[i] = pvy;
+    ay[i] = pay;
+    life[i] = seconds;
+    side[i] = static_cast<unsigned char>(std::min(std::max(pointSide, 1), PARTICLE_MAX_SIDE));
+    color[i] = rgbaColor;
+    head = head + 1 == capacity() ? 0 : head + 1;
+    if (used < capacity()) ++used;
+}
+
+void ParticleSystem::emitBubbles(float px, float py, int count) {
+    for (int n = 0; n < count; ++n) {
+        emit(px + uniform(-12.0f, 12.0f), py + uniform(-8.0f, 8.0f), uniform(-15.0f, 15.0f), uniform(10.0f, 40.0f),
+             BUBBLE_RISE, uniform(1.2f, 2.4f), 2 + rng.nextInt(4), rgba(200, 235, 255, 170));
+    }
+}
+
+void ParticleSystem::emitScales(float px, float py, int count, const unsigned char rgb[3], float speed) {
+    for (int n = 0; n < count; ++n) {
+        float angle = uniform(0.0f, 2.0f * PI);
+        float v = speed * uniform(0.3f, 1.0f);
+        emit(px, py, v * std::cos(angle), v * std::sin(angle), SCALE_SINK, uniform(0.6f, 1.4f), 2 + rng.nextInt(3),
+             rgba(rgb[0], rgb[1], rgb[2], 255));
+    }
+}
+
+void ParticleSystem::emitPlankton(float viewX, float viewY, float viewWidth, float viewHeight, float dt) {
+    planktonDue += ambientCount * std::min(std::max(dt, 0.0f), PARTICLE_MAX_STEP) / PLANKTON_SECONDS;
+    for (; planktonDue >= 1.0f; planktonDue -= 1.0f) {
+        unsigned char green = static_cast<unsigned char>(uniform(180.0f, 255.0f));
+        emit(viewX + uniform(0.0f, viewWidth), viewY + uniform(0.0f, viewHeight), uniform(-6.0f, 6.0f),
+             uniform(-3.0f, 3.0f), 0.0f, uniform(0.5f, 1.0f) * PLANKTON_SECONDS, 1 + rng.nextInt(2),
+             rgba(150, green, 170, 120));
+    }
+}
+
+void ParticleSystem::update(float dt) {
+    dt = std::min(std::max(dt, 0.0f), PARTICLE_MAX_STEP);
+    float damp = std::pow(PARTICLE_DRAG, dt * 60.0f);
+    float* px = x.data();
+    float* py = y.data();
+    float* pvx = vx.data();
+    float* pvy = vy.data();
+    const float* pay = ay.data();
+    float* plife = life.data();
+    size_t n = (used + 3) & ~static_cast<size_t>(3);  // Whole vectors; the pool is a multiple of 4
+    size_t alive = 0;
+
+#if defined(PARTICLES_SSE2)
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vdamp = _mm_set1_ps(damp);
+    const __m128 zero = _mm_setzero_ps();
+    __m128i counts = _mm_setzero_si128();
+    for (size_t i = 0; i < n; i += 4) {
+        __m128 velX = _mm_mul_ps(_mm_loadu_ps(pvx + i), vdamp);
+        __m128 velY = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(pvy + i), vdamp), _mm_mul_ps(_mm_loadu_ps(pay + i), vdt));
+        _mm_storeu_ps(pvx + i, velX);
+        _mm_storeu_ps(pvy + i, velY);
+        _mm_storeu_ps(px + i, _mm_add_ps(_mm_loadu_ps(px + i), _mm_mul_ps(velX, vdt)));
+        _mm_storeu_ps(py + i, _mm_add_ps(_mm_loadu_ps(py + i), _mm_mul_ps(velY, vdt)));
+        __m128 left = _mm_sub_ps(_mm_loadu_ps(plife + i), vdt);
+        _mm_storeu_ps(plife + i, left);
+        counts = _mm_sub_epi32(counts, _mm_castps_si128(_mm_cmpgt_ps(left, zero)));  // Each true lane is -1
+    }
+    int lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), counts);
+    alive = static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#else
+    for (size_t i = 0; i < n; ++i) {
+        pvx[i] *= damp;
+        pvy[i] = pvy[i] * damp + pay[i] * dt;
+        px[i] += pvx[i] * dt;
+        py[i] += pvy[i] * dt;
+        plife[i] -= dt;
+        alive += plife[i] > 0.0f;
+    }
+#endif
+
+    liveCount = alive;
+    if (alive == 0) head = used = 0;  // Start the ring over rather than sweep dead slots
+}
+
+bool ParticleSystem::visible(size_t i, float viewX, float viewY, float viewRight, float viewTop) const {
+    return life[i] > 0.0f && x[i] >= viewX && x[i] <= viewRight && y[i] >= viewY && y[i] <= viewTop;
+}
+
+void ParticleSystem::buildPoints(float viewX, float viewY, float viewWidth, float viewHeight) {
+    float right = viewX + viewWidth, top = viewY + viewHeight;
+
+    // Count by side first, so each side's points land in one run
+    size_t counts[PARTICLE_MAX_SIDE + 1] = {0};
+    for (size_t i = 0; i < used; ++i) {
+        if (visible(i, viewX, viewY, right, top)) ++counts[side[i]];
+    }
+    size_t next[PARTICLE_MAX_SIDE + 1];
+    sideStart[0] = sideStart[1] = 0;
+    for (int s = 1; s <= PARTICLE_MAX_SIDE; ++s) {
+        next[s] = sideStart[s];
+        sideStart[s + 1] = sideStart[s] + counts[s];
+    }
+
+    ParticleVertex* out = &vertices[0];
+    for (size_t i = 0; i < used; ++i) {
+        if (!visible(i, viewX, viewY, right, top)) continue;
+        uint32_t c = color[i];
+        float alpha = static_cast<float>(c >> 24) * std::min(life[i], 1.0f);
+        ParticleVertex v = {x[i], y[i], static_cast<unsigned char>(c), static_cast<unsigned char>(c >> 8),
+                            static_cast<unsigned char>(c >> 16), static_cast<unsigned char>(alpha)};
+        out[next[side[i]]++] = v;
+    }
+    vertexTotal = sideStart[PARTICLE_MAX_SIDE + 1];
+}
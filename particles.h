@@ -0,0 +1,99 @@
+//
+//  particles.h
+//  Fish-Fillet-Project
+//
+//  Eye-candy particles: bubbles, scale bursts and drifting plankton. They
+//  live on the render side, fed by the world's events, and never touch the
+//  simulation, so they do not change a round, a recording or a replay.
+//
+//  The pool is a fixed-capacity ring of structure-of-arrays fields. Emitting
+//  writes at the head and, once the ring is full, over the oldest particle,
+//  so effects never allocate and memory stays at the capacity set up front.
+//  Dead particles stay in their slots until overwritten; the whole ring
+//  empties back to the start as soon as nothing is alive.
+//
+//  update() integrates every slot in one SSE2 pass (4 particles a step).
+//  buildPoints() turns the live particles in view into one flat array of
+//  coloured points grouped by their side in whole pixels, like FishMesh
+//  does for fish, so drawing is one glDrawArrays per side
+//  (particle_renderer.h) and all of this runs headless too. A square point
+//  is one vertex where a quad is four, which is most of the cost on a
+//  software rasterizer.
+//
+
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "rng.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+const size_t PARTICLE_CAPACITY = 65536;     // Slots in the game's pool, a multiple of 4
+const int AMBIENT_PLANKTON = 400;           // Plankton kept drifting in view by default
+const float PARTICLE_DRAG = 0.985f;         // Share of velocity kept per 1/60 s
+const float PARTICLE_MAX_STEP = 0.1f;       // Longest update, in seconds, so a stall does not fling particles
+const int PARTICLE_MAX_SIDE = 5;            // Largest point, px; sides run 1 to this
+
+// Interleaved vertex layout handed straight to glVertexPointer/glColorPointer
+struct ParticleVertex {
+    float x, y;
+    unsigned char r, g, b, a;
+};
+
+class ParticleSystem {
+public:
+    explicit ParticleSystem(size_t capacity = PARTICLE_CAPACITY, uint64_t seed = 1);
+
+    // A rising puff of count bubbles around (x, y), in ocean coordinates
+    void emitBubbles(float x, float y, int count);
+
+    // count scales bursting out of (x, y) and sinking, in the given colour
+    void emitScales(float x, float y, int count, const unsigned char color[3], float speed);
+
+    // Keep the view stocked with about ambientCount plankton: emit this
+    // step's share across the view rectangle
+    void emitPlankton(float viewX, float viewY, float viewWidth, float viewHeight, float dt);
+    void setAmbientCount(int count) { ambientCount = count; }
+
+    // Advance every particle by dt seconds (clamped to PARTICLE_MAX_STEP)
+    void update(float dt);
+
+    // Points for the live particles in the view rectangle, fading out over
+    // their last second
+    void buildPoints(float viewX, float viewY, float viewWidth, float viewHeight);
+
+    void clear();
+
+    size_t capacity() const { return x.size(); }
+    size_t live() const { return liveCount; }     // As of the last update
+    // GL_POINTS from the last buildPoints(): those of a side in pixels are
+    // the sideCount(side) vertices from sideFirst(side)
+    const ParticleVertex* pointVertices() const { return &vertices[0]; }
+    size_t vertexCount() const { return vertexTotal; }
+    size_t sideFirst(int side) const { return sideStart[side]; }
+    size_t sideCount(int side) const { return sideStart[side + 1] - sideStart[side]; }
+
+private:
+    std::vector<float> x, y;
+    std::vector<float> vx, vy;
+    std::vector<float> ay;          // Buoyancy (up) or sinking (down), px/s^2
+    std::vector<float> life;        // Seconds left; dead at zero or below
+    std::vector<unsigned char> side;   // Point side, px
+    std::vector<uint32_t> color;    // r | g << 8 | b << 16 | a << 24
+    std::vector<ParticleVertex> vertices;  // One per slot, sized once
+    size_t vertexTotal;             // Used by the last buildPoints()
+    size_t sideStart[PARTICLE_MAX_SIDE + 2];  // Vertex ranges by side
+    size_t head;                    // Next slot to write
+    size_t used;                    // Slots written since the ring last emptied
+    size_t liveCount;
+    int ambientCount;
+    float planktonDue;              // Fraction of a plankton owed to the view
+    Rng rng;
+
+    float uniform(float lo, float hi);
+    bool visible(size_t i, float viewX, float viewY, float viewRight, float viewTop) const;
+    void emit(float px, float py, float pvx, float pvy, float pay, float seconds, int pointSide, uint32_t rgba);
+};
+
+#endif // PARTICLES_H
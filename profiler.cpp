@@ -0,0 +1,168 @@
+//
+//  profiler.cpp
+//  Fish-Fillet-Project
+//
+
+#include "profiler.h"
+#include <algorithm>
+
+static const char* const PHASE_NAMES[PHASE_COUNT] = {
+    "ocean", "coral", "hud", "flock", "behavior", "collision", "fish draw", "particles", "swap", "frame"
+};
+
+// Small per-thread number for trace rows, in order of first use
+static int traceThreadId() {
+    static std::atomic<int> nextId(1);
+    thread_local int id = nextId.fetch_add(1);
+    return id;
+}
+
+Profiler& profiler() {
+    static Profiler instance;
+    return instance;
+}
+
+Profiler::Profiler()
+    : active(false), sampleCount(0), sampleHead(0), framesSinceStats(0),
+      traceFile(0), traceFramesLeft(0) {
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        frameMs[p] = 0.0;
+        cached[p].minMs = cached[p].avgMs = cached[p].p99Ms = 0.0;
+    }
+    frameStart = traceStart = Clock::now();
+}
+
+Profiler::~Profiler() {
+    finishTrace();
+}
+
+const char* Profiler::phaseName(ProfilePhase phase) {
+    return PHASE_NAMES[phase];
+}
+
+void Profiler::setEnabled(bool on) {
+    std::lock_guard<std::mutex> guard(lock);
+    active.store(on || traceFile != 0);
+}
+
+bool Profiler::tracing() {
+    std::lock_guard<std::mutex> guard(lock);
+    return traceFile != 0;
+}
+
+void Profiler::nameThread(const char* name) {
+    int id = traceThreadId();
+    std::lock_guard<std::mutex> guard(lock);
+    if (threadNames.size() <= static_cast<size_t>(id)) threadNames.resize(id + 1);
+    threadNames[id] = name;
+}
+
+void Profiler::beginFrame() {
+    if (!enabled()) return;
+    std::lock_guard<std::mutex> guard(lock);
+    frameStart = Clock::now();
+    if (traceFile && traceEvents.empty()) traceStart = frameStart;  // Trace starts at zero
+}
+
+void Profiler::add(ProfilePhase phase, Clock::time_point start, Clock::time_point end) {
+    std::lock_guard<std::mutex> guard(lock);
+    record(phase, start, end);
+}
+
+void Profiler::record(ProfilePhase phase, Clock::time_point start, Clock::time_point end) {
+    std::chrono::duration<double, std::milli> ms = end - start;
+    frameMs[phase] += ms.count();
+    if (traceFile) {
+        std::chrono::duration<double, std::micro> at = start - traceStart;
+        TraceEvent e = { phase, traceThreadId(), at.count(), ms.count() * 1000.0 };
+        traceEvents.push_back(e);
+    }
+}
+
+void Profiler::endFrame() {
+    if (!enabled()) return;
+    Clock::time_point now = Clock::now();
+    std::lock_guard<std::mutex> guard(lock);
+    frameMs[PHASE_FRAME] = 0.0;
+    record(PHASE_FRAME, frameStart, now);
+
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        samples[p][sampleHead] = static_cast<float>(frameMs[p]);
+        frameMs[p] = 0.0;
+    }
+    sampleHead = (sampleHead + 1) % PROFILE_WINDOW;
+    if (sampleCount < PROFILE_WINDOW) ++sampleCount;
+    if (++framesSinceStats >= PROFILE_STATS_INTERVAL) {
+        refreshStats();
+    }
+
+    if (traceFile && --traceFramesLeft <= 0) {
+        writeTrace();
+    }
+}
+
+void Profiler::refreshStats() {
+    framesSinceStats = 0;
+    if (sampleCount == 0) return;
+    float sorted[PROFILE_WINDOW];
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        std::copy(samples[p], samples[p] + sampleCount, sorted);
+        std::sort(sorted, sorted + sampleCount);
+        double total = 0.0;
+        for (int i = 0; i < sampleCount; ++i) total += sorted[i];
+        cached[p].minMs = sorted[0];
+        cached[p].avgMs = total / sampleCount;
+        cached[p].p99Ms = sorted[std::min(sampleCount - 1, sampleCount * 99 / 100)];
+    }
+}
+
+bool Profiler::startTrace(const char* path, int frames) {
+    std::lock_guard<std::mutex> guard(lock);
+    writeTrace();
+    traceFile = std::fopen(path, "w");
+    if (!traceFile) return false;
+    traceFramesLeft = frames;
+    traceEvents.clear();
+    traceEvents.reserve(static_cast<size_t>(frames) * PHASE_COUNT * 2);
+    traceStart = Clock::now();
+    active = true;
+    return true;
+}
+
+void Profiler::finishTrace() {
+    std::lock_guard<std::mutex> guard(lock);
+    writeTrace();
+}
+
+void Profiler::writeTrace() {
+    if (!traceFile) return;
+    std::fprintf(traceFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (size_t t = 0; t < threadNames.size(); ++t) {
+        if (threadNames[t].empty()) continue;
+        std::fprintf(traceFile, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}},\n",
+                     static_cast<int>(t), threadNames[t].c_str());
+    }
+    for (size_t i = 0; i < traceEvents.size(); ++i) {
+        const TraceEvent& e = traceEvents[i];
+        // Complete events on their thread's row; phases nest under their frame
+        std::fprintf(traceFile,
+                     "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}%s\n",
+                     PHASE_NAMES[e.phase], e.phase == PHASE_FRAME ? "frame" : "phase",
+                     e.startUs, e.durationUs, e.thread, i + 1 < traceEvents.size() ? "," : "");
+    }
+    std::fprintf(traceFile, "]}\n");
+    std::fclose(traceFile);
+    traceFile = 0;
+    traceEvents.clear();
+}
+
+void Profiler::report(std::FILE* out) {
+    std::lock_guard<std::mutex> guard(lock);
+    refreshStats();
+    std::fprintf(out, "%-10s %9s %9s %9s   (last %d frames)\n", "phase", "min ms", "avg ms", "p99 ms",
+                 sampleCount);
+    for (int p = 0; p < PHASE_COUNT; ++p) {
+        std::fprintf(out, "%-10s %9.3f %9.3f %9.3f\n", PHASE_NAMES[p],
+                     cached[p].minMs, cached[p].avgMs, cached[p].p99Ms);
+    }
+}
@@ -0,0 +1,133 @@
+//
+//  profiler.h
+//  Fish-Fillet-Project
+//
+//  Scoped phase timers for the frame loop. Each frame sums the time spent
+//  in every phase; the last PROFILE_WINDOW frames feed the min/avg/p99 shown
+//  in the overlay, and a capture of a chosen number of frames can be written
+//  as Chrome trace-event JSON (load it in chrome://tracing or Perfetto).
+//  While the profiler is disabled a ProfileScope is a single branch, so the
+//  timers stay compiled into release builds. Scopes may close on any
+//  thread (the simulation thread times behavior and collision); frame
+//  boundaries come from the render thread.
+//
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum ProfilePhase {
+    PHASE_OCEAN = 0,
+    PHASE_CORAL,
+    PHASE_HUD,
+    PHASE_FLOCK,
+    PHASE_BEHAVIOR,
+    PHASE_COLLISION,
+    PHASE_FISH_DRAW,
+    PHASE_PARTICLES,
+    PHASE_SWAP,
+    PHASE_FRAME,        // Whole frame, beginFrame() to endFrame()
+    PHASE_COUNT
+};
+
+const int PROFILE_WINDOW = 240;        // Frames in the rolling statistics
+const int PROFILE_STATS_INTERVAL = 30; // Frames between statistics refreshes
+
+struct PhaseStats {
+    double minMs, avgMs, p99Ms;
+};
+
+class Profiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    Profiler();
+    ~Profiler();
+
+    bool enabled() const { return active.load(std::memory_order_relaxed); }
+    void setEnabled(bool on);
+
+    // Label the calling thread's row in traces
+    void nameThread(const char* name);
+
+    // Frame boundaries; phases timed outside a frame still count toward
+    // the next one (ticks run before the frame that displays them)
+    void beginFrame();
+    void endFrame();
+
+    void add(ProfilePhase phase, Clock::time_point start, Clock::time_point end);
+
+    // Rolling statistics, refreshed every PROFILE_STATS_INTERVAL frames
+    const PhaseStats& stats(ProfilePhase phase) const { return cached[phase]; }
+    int framesSampled() const { return sampleCount; }
+
+    // Record every scope of the next `frames` frames, then write the trace.
+    // Returns false if the file cannot be created.
+    bool startTrace(const char* path, int frames);
+    bool tracing();
+
+    // Write whatever has been captured so far (for exits mid-capture)
+    void finishTrace();
+
+    // Refresh the statistics and print them as a table
+    void report(std::FILE* out);
+
+    static const char* phaseName(ProfilePhase phase);
+
+private:
+    struct TraceEvent {
+        int phase;
+        int thread;
+        double startUs, durationUs;
+    };
+
+    std::atomic<bool> active;
+    std::mutex lock;                              // Guards everything below
+    Clock::time_point frameStart;
+    Clock::time_point traceStart;
+    double frameMs[PHASE_COUNT];                  // Running sums for the current frame
+    float samples[PHASE_COUNT][PROFILE_WINDOW];   // Ring of per-frame sums
+    int sampleCount;                              // Frames in the ring, up to PROFILE_WINDOW
+    int sampleHead;
+    int framesSinceStats;
+    PhaseStats cached[PHASE_COUNT];
+
+    std::FILE* traceFile;
+    int traceFramesLeft;
+    std::vector<TraceEvent> traceEvents;
+    std::vector<std::string> threadNames;         // By trace thread id
+
+    void record(ProfilePhase phase, Clock::time_point start, Clock::time_point end);
+    void writeTrace();
+    void refreshStats();
+};
+
+// The profiler the game loop and the simulation report to
+Profiler& profiler();
+
+// Times the enclosing block into one phase of the current frame
+class ProfileScope {
+public:
+    explicit ProfileScope(ProfilePhase p) : phase(p), live(profiler().enabled()) {
+        if (live) start = Profiler::Clock::now();
+    }
+    ~ProfileScope() {
+        if (live) profiler().add(phase, start, Profiler::Clock::now());
+    }
+
+private:
+    ProfilePhase phase;
+    bool live;
+    Profiler::Clock::time_point start;
+
+    ProfileScope(const ProfileScope&);
+    ProfileScope& operator=(const ProfileScope&);
+};
+
+#endif // PROFILER_H
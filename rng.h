@@ -0,0 +1,59 @@
+//
+//  rng.h
+//  Fish-Fillet-Project
+//
+//  Small seedable PRNG (PCG32, XSH-RR variant). Every World owns one, so a
+//  round is fully determined by its seed and the input it receives; nothing
+//  in the simulation may touch the global rand().
+//
+
+#ifndef RNG_H
+#define RNG_H
+
+#include <cstdint>
+
+class Rng {
+public:
+    explicit Rng(uint64_t seedValue = 0x853c49e6748fea9bULL) {
+        seed(seedValue);
+    }
+
+    void seed(uint64_t seedValue) {
+        state = 0;
+        inc = (0xda3e39cb94b95bdbULL << 1) | 1u;
+        next();
+        state += seedValue;
+        next();
+    }
+
+    uint32_t next() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorShifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorShifted >> rot) | (xorShifted << ((32 - rot) & 31));
+    }
+
+    // Uniform integer in [0, n) for n > 0 (multiply-shift, no modulo)
+    int nextInt(int n) {
+        return static_cast<int>((static_cast<uint64_t>(next()) * static_cast<uint32_t>(n)) >> 32);
+    }
+
+    // Raw generator state, for save files and replay headers
+    uint64_t rawState() const { return state; }
+    void setRawState(uint64_t s) { state = s; }
+
+private:
+    uint64_t state;
+    uint64_t inc;
+};
+
+// SplitMix64 step: derives well-spread seeds from one master seed
+inline uint64_t nextSeed(uint64_t& sequence) {
+    uint64_t z = (sequence += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+#endif // RNG_H
@@ -0,0 +1,145 @@
+//
+//  sim_thread.cpp
+//  Fish-Fillet-Project
+//
+
+#include "sim_thread.h"
+#include "alloc_stats.h"
+#include "profiler.h"
+#include <cstdio>
+#include <utility>
+
+static const SimulationThread::Clock::duration TICK_DURATION =
+    std::chrono::duration_cast<SimulationThread::Clock::duration>(std::chrono::duration<double>(SIM_DT));
+
+SimulationThread::SimulationThread()
+    : world(0), recorder(0), levelWatcher(0), stopRequested(false), heapAllocations(0),
+      hasPrevious(false) {}
+
+SimulationThread::~SimulationThread() {
+    stop();
+}
+
+void SimulationThread::start(World& target, InputRecorder* inputRecorder, LevelWatcher* watcher) {
+    stop();
+    world = &target;
+    recorder = inputRecorder;
+    levelWatcher = watcher;
+    stopRequested.store(false);
+    hasPrevious = false;
+    publish(Clock::now());
+    snapshots.acquire();
+    current = snapshots.readSlot();
+    thread = std::thread(&SimulationThread::run, this);
+}
+
+void SimulationThread::stop() {
+    if (!thread.joinable()) return;
+    stopRequested.store(true);
+    thread.join();
+}
+
+bool SimulationThread::post(const InputEvent& event) {
+    TimedInput input = { event, Clock::now() };
+    return inputs.push(input);
+}
+
+bool SimulationThread::postMouse(int x, int y) {
+    InputEvent event = { INPUT_MOUSE, 0, x, y };
+    return post(event);
+}
+
+bool SimulationThread::postKey(int key) {
+    InputEvent event = { INPUT_KEY, 0, key, 0 };
+    return post(event);
+}
+
+void SimulationThread::applyInputs(Clock::time_point upTo) {
+    const TimedInput* input;
+    while ((input = inputs.front()) && input->time <= upTo) {
+        const InputEvent& e = input->event;
+        // Record with the tick the event lands before, as replay expects
+        if (recorder) {
+            if (e.type == INPUT_MOUSE) recorder->mouse(world->tickCount, e.x, e.y);
+            else recorder->key(world->tickCount, e.x);
+        }
+        applyInput(*world, e, &history);
+        if (recorder && e.type == INPUT_KEY && jumpsInTime(e.x)) recorder->seek(world->tickCount);
+        inputs.pop();
+    }
+}
+
+void SimulationThread::publish(Clock::time_point tickTime) {
+    WorldSnapshot& slot = snapshots.writeSlot();
+    slot.capture(*world);
+    slot.time = tickTime;
+    snapshots.publish();
+}
+
+// Hot reload: the new level takes effect as a restart of the current round.
+// A broken edit keeps the old level running.
+void SimulationThread::reloadLevel() {
+    std::string error;
+    std::shared_ptr<const Level> level = levelWatcher->poll(error);
+    if (level) {
+        world->setLevel(level);
+        std::printf("level: reloaded %s (%s)\n", levelWatcher->path().c_str(), level->rules.name);
+    } else if (!error.empty()) {
+        std::fprintf(stderr, "level: %s\n", error.c_str());
+    }
+}
+
+void SimulationThread::run() {
+    profiler().nameThread("simulation");
+    Clock::time_point next = Clock::now();  // When the next tick is due
+    int ticksSincePoll = 0;
+    while (!stopRequested.load(std::memory_order_relaxed)) {
+        Clock::time_point now = Clock::now();
+        if (now < next) {
+            std::this_thread::sleep_until(next);
+            continue;
+        }
+
+        Clock::time_point lastTick = next;
+        int steps = 0;
+        while (next <= now && steps < MAX_STEPS_PER_FRAME) {
+            applyInputs(next);
+            world->tick();
+            history.afterTick(*world);
+            for (size_t i = 0; i < world->events.size(); ++i) {
+                events.push(world->events[i]);  // Sounds are best effort
+            }
+            world->events.clear();
+            lastTick = next;
+            next += TICK_DURATION;
+            ++steps;
+            ++ticksSincePoll;
+        }
+        if (levelWatcher && ticksSincePoll >= TICKS_PER_SECOND) {
+            ticksSincePoll = 0;
+            reloadLevel();
+        }
+        // Drop time we could never catch up on rather than stalling further
+        if (next <= now) next = now + TICK_DURATION;
+
+        publish(lastTick);
+        heapAllocations.store(threadAllocations().allocations, std::memory_order_relaxed);
+    }
+}
+
+const WorldSnapshot& SimulationThread::view(Clock::time_point now) {
+    if (snapshots.acquire()) {
+        std::swap(previous, current);
+        current = snapshots.readSlot();
+        hasPrevious = true;
+    }
+    if (!hasPrevious) return current;
+
+    // Draw one tick behind the newest state so there is a pair to blend
+    Clock::time_point drawTime = now - TICK_DURATION;
+    std::chrono::duration<double> span = current.time - previous.time;
+    std::chrono::duration<double> into = drawTime - previous.time;
+    float alpha = span.count() > 0.0 ? static_cast<float>(into.count() / span.count()) : 1.0f;
+    blended.blend(previous, current, alpha, slotScratch);
+    return blended;
+}
@@ -0,0 +1,103 @@
+//
+//  sim_thread.h
+//  Fish-Fillet-Project
+//
+//  Runs a World on its own thread at the fixed tick rate, so a slow frame
+//  no longer holds up gameplay. Three lock-free channels connect it to the
+//  GLUT thread:
+//    input    GLUT -> sim   SPSC queue of mouse/key events stamped with the
+//                           time they arrived; each is applied before the
+//                           first tick scheduled at or after that time
+//    state    sim -> GLUT   triple buffer of WorldSnapshots, one per tick batch
+//    events   sim -> GLUT   SPSC queue of WorldEvents for sounds
+//  With a LevelWatcher the simulation also checks the level file once a
+//  second and restarts the round under the new rules when it changes.
+//  The simulation also keeps the save-state checkpoints (world_state.h)
+//  that the quick save, quick load and rewind keys work on.
+//  The render side keeps the last two snapshots it saw and draws one tick in
+//  the past, blended between them, so motion stays smooth at any frame rate.
+//
+
+#ifndef SIM_THREAD_H
+#define SIM_THREAD_H
+
+#include "input_record.h"
+#include "spsc_queue.h"
+#include "triple_buffer.h"
+#include "world.h"
+#include "world_snapshot.h"
+#include "world_state.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+const size_t INPUT_QUEUE_SIZE = 1024;   // About four seconds of 250 Hz mouse input
+const size_t EVENT_QUEUE_SIZE = 256;
+
+class SimulationThread {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    SimulationThread();
+    ~SimulationThread();
+
+    // Take over world (and recorder and level watcher, either of which may
+    // be null) until stop()
+    void start(World& world, InputRecorder* recorder, LevelWatcher* levelWatcher = 0);
+    void stop();
+    bool running() const { return thread.joinable(); }
+
+    // GLUT thread: queue input; false if the queue was full and it was dropped
+    bool postMouse(int x, int y);
+    bool postKey(int key);
+
+    // GLUT thread: next simulation event for sound, if any
+    bool pollEvent(WorldEvent& event) { return events.pop(event); }
+
+    // GLUT thread: the state to draw at time `now`
+    const WorldSnapshot& view(Clock::time_point now);
+
+    // Heap allocations made on the simulation thread so far, as of the last
+    // tick batch (see alloc_stats.h)
+    uint64_t allocations() const { return heapAllocations.load(std::memory_order_relaxed); }
+
+    // Checkpoints of the round being played; only newestCheckpoint() may be
+    // read off the simulation thread
+    const StateHistory& stateHistory() const { return history; }
+
+private:
+    struct TimedInput {
+        InputEvent event;
+        Clock::time_point time;
+    };
+
+    World* world;
+    InputRecorder* recorder;
+    LevelWatcher* levelWatcher;
+    std::thread thread;
+    std::atomic<bool> stopRequested;
+    std::atomic<uint64_t> heapAllocations;
+
+    SpscQueue<TimedInput, INPUT_QUEUE_SIZE> inputs;
+    SpscQueue<WorldEvent, EVENT_QUEUE_SIZE> events;
+    TripleBuffer<WorldSnapshot> snapshots;
+    StateHistory history;
+
+    // Render-side state
+    WorldSnapshot previous;
+    WorldSnapshot current;
+    WorldSnapshot blended;
+    std::vector<int> slotScratch;
+    bool hasPrevious;
+
+    bool post(const InputEvent& event);
+    void applyInputs(Clock::time_point upTo);
+    void publish(Clock::time_point tickTime);
+    void reloadLevel();
+    void run();
+
+    SimulationThread(const SimulationThread&);
+    SimulationThread& operator=(const SimulationThread&);
+};
+
+#endif // SIM_THREAD_H
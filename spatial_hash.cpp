@@ -0,0 +1,62 @@
+//
+//  spatial_hash.cpp
+//  Fish-Fillet-Project
+//
+
+#include "spatial_hash.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialHash::SpatialHash(float width, float height, float cellSize)
+    : edge(cellSize),
+      invCellSize(1.0f / cellSize),
+      originX(0.0f),
+      originY(0.0f),
+      cols(std::max(1, static_cast<int>(std::ceil(width / cellSize)))),
+      rows(std::max(1, static_cast<int>(std::ceil(height / cellSize)))),
+      maxCol(static_cast<float>(cols - 1)),
+      maxRow(static_cast<float>(rows - 1)),
+      cellStart(cols * rows + 1, 0),
+      cellCursor(cols * rows, 0) {}
+
+void SpatialHash::build(const float* xs, const float* ys, size_t count) {
+    std::fill(cellStart.begin(), cellStart.end(), 0);
+    pointCell.resize(count);
+    entries.resize(count);
+    cellX.resize(count);
+    cellY.resize(count);
+
+    // Count points per cell (shifted by one so the prefix sum lands in place)
+    for (size_t i = 0; i < count; ++i) {
+        int col, row;
+        cellRange(xs[i], ys[i], col, row);
+        int cell = row * cols + col;
+        pointCell[i] = cell;
+        ++cellStart[cell + 1];
+    }
+    for (size_t c = 1; c < cellStart.size(); ++c) {
+        cellStart[c] += cellStart[c - 1];
+    }
+
+    // Scatter; walking i upwards keeps each cell's indices ascending
+    cellCursor.assign(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < count; ++i) {
+        int slot = cellCursor[pointCell[i]]++;
+        entries[slot] = static_cast<int>(i);
+        cellX[slot] = xs[i];
+        cellY[slot] = ys[i];
+    }
+}
+
+void SpatialHash::reserve(size_t count) {
+    pointCell.reserve(count);
+    entries.reserve(count);
+    cellX.reserve(count);
+    cellY.reserve(count);
+}
+
+void SpatialHash::queryRadius(float x, float y, float radius, std::vector<int>& out) const {
+    out.clear();
+    forEachInRadius(x, y, radius, [&out](int index) { out.push_back(index); });
+    std::sort(out.begin(), out.end());
+}
@@ -0,0 +1,152 @@
+//
+//  spatial_hash.h
+//  Fish-Fillet-Project
+//
+//  Uniform-grid broad phase over the ocean. The grid is rebuilt from the
+//  fish positions once per tick with a counting sort, so a rebuild is O(n)
+//  and a radius query only touches the cells the circle overlaps. Points
+//  outside the grid are clamped into the border cells, which keeps queries
+//  correct for fish that are mid-wrap or a player above the waterline.
+//  The grid can be moved with setOrigin, so in a scrolling world it only
+//  has to cover the chunks that are awake.
+//
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+const float SPATIAL_CELL_SIZE = 64.0f;  // Roughly two large-fish diameters
+
+class SpatialHash {
+public:
+    SpatialHash(float width, float height, float cellSize = SPATIAL_CELL_SIZE);
+
+    // Bucket points [0, count) by cell; previous contents are discarded
+    void build(const float* xs, const float* ys, size_t count);
+
+    // Make room for builds of up to count points without allocating
+    void reserve(size_t count);
+
+    // Put the grid's lower-left corner at (x, y); call before build
+    void setOrigin(float x, float y) {
+        originX = x;
+        originY = y;
+    }
+
+    // Call fn(index, squaredDistance) for every point within radius of
+    // (x, y), cell by cell
+    template <class Fn>
+    void forEachNear(float x, float y, float radius, Fn fn) const {
+        int minCol, minRow, maxCol, maxRow;
+        cellRange(x - radius, y - radius, minCol, minRow);
+        cellRange(x + radius, y + radius, maxCol, maxRow);
+        float radius2 = radius * radius;
+        for (int row = minRow; row <= maxRow; ++row) {
+            for (int col = minCol; col <= maxCol; ++col) {
+                int cell = row * cols + col;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                    float dx = cellX[k] - x;
+                    float dy = cellY[k] - y;
+                    float dist2 = dx * dx + dy * dy;
+                    if (dist2 <= radius2) fn(entries[k], dist2);
+                }
+            }
+        }
+    }
+
+    // Call fn(index) for every point within radius of (x, y), cell by cell
+    template <class Fn>
+    void forEachInRadius(float x, float y, float radius, Fn fn) const {
+        forEachNear(x, y, radius, [&fn](int index, float) { fn(index); });
+    }
+
+    // Call fn(index) for every point within radius of the segment from
+    // (x0, y0) to (x1, y1): the cells under the capsule's bounding box,
+    // skipping those the capsule cannot reach
+    template <class Fn>
+    void forEachNearSegment(float x0, float y0, float x1, float y1, float radius, Fn fn) const {
+        int minCol, minRow, maxCol, maxRow;
+        cellRange(std::min(x0, x1) - radius, std::min(y0, y1) - radius, minCol, minRow);
+        cellRange(std::max(x0, x1) + radius, std::max(y0, y1) + radius, maxCol, maxRow);
+        float dx = x1 - x0;
+        float dy = y1 - y0;
+        float length2 = dx * dx + dy * dy;
+        float invLength2 = length2 > 0.0f ? 1.0f / length2 : 0.0f;
+        float radius2 = radius * radius;
+        float cellReach = radius + edge * 0.70710678f;  // Plus half a cell diagonal
+        float cellReach2 = cellReach * cellReach;
+        for (int row = minRow; row <= maxRow; ++row) {
+            for (int col = minCol; col <= maxCol; ++col) {
+                float centerX = originX + (col + 0.5f) * edge;
+                float centerY = originY + (row + 0.5f) * edge;
+                // Border cells also hold clamped points from outside the grid
+                bool border = col == 0 || row == 0 || col == cols - 1 || row == rows - 1;
+                if (!border && segmentDistance2(centerX, centerY, x0, y0, dx, dy, invLength2) > cellReach2) {
+                    continue;
+                }
+                int cell = row * cols + col;
+                for (int k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                    if (segmentDistance2(cellX[k], cellY[k], x0, y0, dx, dy, invLength2) <= radius2) {
+                        fn(entries[k]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Indices within radius of (x, y), in ascending order
+    void queryRadius(float x, float y, float radius, std::vector<int>& out) const;
+
+    // Points bucketed in the cell containing (x, y)
+    int cellPopulation(float x, float y) const {
+        int col, row;
+        cellRange(x, y, col, row);
+        int cell = row * cols + col;
+        return cellStart[cell + 1] - cellStart[cell];
+    }
+
+    int columnCount() const { return cols; }
+    int rowCount() const { return rows; }
+    float cellSize() const { return edge; }
+
+private:
+    float edge;
+    float invCellSize;
+    float originX, originY;
+    int cols, rows;
+    float maxCol, maxRow;         // cols - 1 and rows - 1 as floats
+    std::vector<int> cellStart;   // cols * rows + 1 prefix sums into entries
+    std::vector<int> entries;     // Point indices grouped by cell
+    std::vector<float> cellX;     // Positions in entries order, for cache-friendly tests
+    std::vector<float> cellY;
+    std::vector<int> pointCell;   // Scratch: cell of each point during build
+    std::vector<int> cellCursor;  // Scratch: next free slot per cell during build
+
+    // Squared distance from (px, py) to the segment from (x0, y0) by (dx, dy)
+    static float segmentDistance2(float px, float py, float x0, float y0, float dx, float dy, float invLength2) {
+        float t = ((px - x0) * dx + (py - y0) * dy) * invLength2;
+        if (t < 0.0f) t = 0.0f;
+        if (t > 1.0f) t = 1.0f;
+        float ex = x0 + t * dx - px;
+        float ey = y0 + t * dy - py;
+        return ex * ex + ey * ey;
+    }
+
+    // Clamp in float before converting, so truncation acts as floor and
+    // far-away coordinates cannot overflow the int conversion
+    void cellRange(float x, float y, int& col, int& row) const {
+        float fx = (x - originX) * invCellSize;
+        float fy = (y - originY) * invCellSize;
+        if (fx < 0.0f) fx = 0.0f;
+        if (fy < 0.0f) fy = 0.0f;
+        if (fx > maxCol) fx = maxCol;
+        if (fy > maxRow) fy = maxRow;
+        col = static_cast<int>(fx);
+        row = static_cast<int>(fy);
+    }
+};
+
+#endif // SPATIAL_HASH_H
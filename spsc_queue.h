@@ -0,0 +1,60 @@
+//
+//  spsc_queue.h
+//  Fish-Fillet-Project
+//
+//  Lock-free bounded ring for exactly one producer thread and one consumer
+//  thread. Capacity must be a power of two. push() fails instead of blocking
+//  when the ring is full.
+//
+
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+template <class T, size_t Capacity>
+class SpscQueue {
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // Producer side
+    bool push(const T& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) return false;
+        items[t & (Capacity - 1)] = value;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: oldest item, or null when empty
+    const T* front() const {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return 0;
+        return &items[h & (Capacity - 1)];
+    }
+
+    void pop() {
+        head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool pop(T& value) {
+        const T* item = front();
+        if (!item) return false;
+        value = *item;
+        pop();
+        return true;
+    }
+
+private:
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+
+    T items[Capacity];
+    std::atomic<size_t> head;   // Next item to read, written by the consumer
+    std::atomic<size_t> tail;   // Next slot to write, written by the producer
+
+    SpscQueue(const SpscQueue&);
+    SpscQueue& operator=(const SpscQueue&);
+};
+
+#endif // SPSC_QUEUE_H
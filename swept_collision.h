@@ -0,0 +1,46 @@
+//
+//  swept_collision.h
+//  Fish-Fillet-Project
+//
+//  Continuous circle-vs-circle test for the player, which jumps straight to
+//  the mouse on every input. Testing only where it lands lets a fast flick
+//  pass through fish; sweeping its circle along the tick's motion segment
+//  finds every fish it crossed, and when.
+//
+
+#ifndef SWEPT_COLLISION_H
+#define SWEPT_COLLISION_H
+
+#include <cmath>
+
+// When a circle moving from (x0, y0) by (dx, dy) over t in [0, 1] overlaps
+// a circle resting at (cx, cy), where radius is the sum of both radii.
+// Overlap is strict (distance < radius), like the resting test. Returns
+// false if they never overlap; otherwise entry and exit bound the overlap
+// within [0, 1], with entry 0 if they already overlap at the start.
+inline bool sweepCircle(float x0, float y0, float dx, float dy, float cx, float cy, float radius,
+                        float& entry, float& exit) {
+    float mx = x0 - cx;
+    float my = y0 - cy;
+    // |m + t d|^2 < r^2  <=>  a t^2 + 2 b t + c < 0
+    float a = dx * dx + dy * dy;
+    float b = mx * dx + my * dy;
+    float c = mx * mx + my * my - radius * radius;
+    if (a <= 0.0f) {
+        if (c >= 0.0f) return false;  // Not moving and not touching
+        entry = 0.0f;
+        exit = 1.0f;
+        return true;
+    }
+    float disc = b * b - a * c;
+    if (disc <= 0.0f) return false;  // The line misses, or only grazes
+    float root = std::sqrt(disc);
+    float t0 = (-b - root) / a;
+    float t1 = (-b + root) / a;
+    if (t0 >= 1.0f || t1 <= 0.0f) return false;  // Overlap lies outside this tick
+    entry = t0 > 0.0f ? t0 : 0.0f;
+    exit = t1 < 1.0f ? t1 : 1.0f;
+    return true;
+}
+
+#endif // SWEPT_COLLISION_H
@@ -0,0 +1,272 @@
+//
+//  text_renderer.cpp
+//  Fish-Fillet-Project
+//
+
+#ifdef __APPLE__
+#define GL_SILENCE_DEPRECATION
+#include <GLUT/glut.h>
+#else
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glut.h>
+#endif
+#include "text_renderer.h"
+#include "game_config.h"
+#include <cstring>
+
+// Capture cell around each glyph's pen position. Bitmap glyphs can start
+// left of the pen and hang below the baseline, so leave room on every side.
+static const int CELL_PAD = 4;
+static const int CELL_DESCENT[FONT_COUNT] = {6, 10};
+static const int CELL_HEIGHT[FONT_COUNT] = {20, 36};
+
+static void* glutFont(FontFace face) {
+    return face == FONT_TIMES_ROMAN_24 ? GLUT_BITMAP_TIMES_ROMAN_24 : GLUT_BITMAP_HELVETICA_12;
+}
+
+static void toBytes(const float color[3], unsigned char rgb[3]) {
+    for (int k = 0; k < 3; ++k) {
+        float c = color[k] < 0.0f ? 0.0f : (color[k] > 1.0f ? 1.0f : color[k]);
+        rgb[k] = static_cast<unsigned char>(c * 255.0f + 0.5f);
+    }
+}
+
+TextLabel::TextLabel() : face(FONT_HELVETICA_12), x(0), y(0), laidOut(false) {
+    rgb[0] = rgb[1] = rgb[2] = 0;
+}
+
+void TextLabel::set(const TextRenderer& text, FontFace newFace, int newX, int newY,
+                    const char* str, const float color[3]) {
+    unsigned char newRgb[3];
+    toBytes(color, newRgb);
+    if (laidOut == text.ready() && newFace == face && newX == x && newY == y &&
+        std::memcmp(newRgb, rgb, 3) == 0 && current == str) {
+        return;
+    }
+    current = str;
+    face = newFace;
+    x = newX;
+    y = newY;
+    std::memcpy(rgb, newRgb, 3);
+    quads.clear();
+    laidOut = text.ready();
+    if (laidOut) text.layout(face, x, y, str, rgb, quads);
+}
+
+TextRenderer::TextRenderer() : attempted(false), atlasTexture(0) {
+    std::memset(glyphs, 0, sizeof(glyphs));
+}
+
+void TextRenderer::init() {
+    if (attempted) return;
+    attempted = true;
+    if (!buildAtlas() && atlasTexture) {
+        glDeleteTextures(1, &atlasTexture);
+        atlasTexture = 0;
+    }
+}
+
+bool TextRenderer::buildAtlas() {
+    GLint viewport[4];
+    GLint maxTexture = 0;
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTexture);
+    if (viewport[0] != 0 || viewport[1] != 0 ||
+        viewport[2] != WINDOW_WIDTH || viewport[3] != WINDOW_HEIGHT ||
+        WINDOW_WIDTH < GLYPH_ATLAS_WIDTH || WINDOW_HEIGHT < GLYPH_ATLAS_HEIGHT ||
+        maxTexture < GLYPH_ATLAS_HEIGHT) {
+        return false;
+    }
+
+    // Lay the cells out in rows, font after font, and draw every glyph in
+    // white on black at the place it will have in the atlas
+    int cellX[FONT_COUNT][LAST_GLYPH - FIRST_GLYPH + 1];
+    int cellY[FONT_COUNT][LAST_GLYPH - FIRST_GLYPH + 1];
+    int cellWidth[FONT_COUNT];
+
+    GLfloat clearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glDisable(GL_BLEND);
+    glColor3f(1.0f, 1.0f, 1.0f);
+
+    int penX = 0, rowY = 0;
+    for (int f = 0; f < FONT_COUNT; ++f) {
+        int widest = 0;
+        for (int c = FIRST_GLYPH; c <= LAST_GLYPH; ++c) {
+            int w = glutBitmapWidth(glutFont(static_cast<FontFace>(f)), c);
+            if (w > widest) widest = w;
+        }
+        cellWidth[f] = widest + 2 * CELL_PAD;
+        if (penX > 0) {
+            penX = 0;
+            rowY += CELL_HEIGHT[f - 1];
+        }
+        for (int c = FIRST_GLYPH; c <= LAST_GLYPH; ++c) {
+            if (penX + cellWidth[f] > GLYPH_ATLAS_WIDTH) {
+                penX = 0;
+                rowY += CELL_HEIGHT[f];
+            }
+            int g = c - FIRST_GLYPH;
+            cellX[f][g] = penX;
+            cellY[f][g] = rowY;
+            glyphs[f][g].advance = static_cast<short>(glutBitmapWidth(glutFont(static_cast<FontFace>(f)), c));
+            glRasterPos2i(penX + CELL_PAD, rowY + CELL_DESCENT[f]);
+            glutBitmapCharacter(glutFont(static_cast<FontFace>(f)), c);
+            penX += cellWidth[f];
+        }
+    }
+    if (rowY + CELL_HEIGHT[FONT_COUNT - 1] > GLYPH_ATLAS_HEIGHT) {
+        glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+        return false;
+    }
+
+    std::vector<unsigned char> coverage(GLYPH_ATLAS_WIDTH * GLYPH_ATLAS_HEIGHT);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, GLYPH_ATLAS_WIDTH, GLYPH_ATLAS_HEIGHT, GL_RED, GL_UNSIGNED_BYTE, &coverage[0]);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    // Bitmap text is either fully on or off; make the alpha exact
+    bool anyInk = false;
+    for (size_t i = 0; i < coverage.size(); ++i) {
+        coverage[i] = coverage[i] >= 128 ? 255 : 0;
+        anyInk = anyInk || coverage[i];
+    }
+    if (!anyInk) return false;
+
+    // Shrink each glyph's quad to the pixels it actually covers
+    for (int f = 0; f < FONT_COUNT; ++f) {
+        for (int g = 0; g <= LAST_GLYPH - FIRST_GLYPH; ++g) {
+            int x0 = cellX[f][g], y0 = cellY[f][g];
+            int minX = cellWidth[f], minY = CELL_HEIGHT[f], maxX = -1, maxY = -1;
+            for (int y = 0; y < CELL_HEIGHT[f]; ++y) {
+                const unsigned char* row = &coverage[(y0 + y) * GLYPH_ATLAS_WIDTH + x0];
+                for (int x = 0; x < cellWidth[f]; ++x) {
+                    if (!row[x]) continue;
+                    if (x < minX) minX = x;
+                    if (x > maxX) maxX = x;
+                    if (y < minY) minY = y;
+                    if (y > maxY) maxY = y;
+                }
+            }
+            Glyph& glyph = glyphs[f][g];
+            if (maxX < 0) continue;  // Space and other blanks only advance
+            glyph.left = static_cast<short>(minX - CELL_PAD);
+            glyph.bottom = static_cast<short>(minY - CELL_DESCENT[f]);
+            glyph.width = static_cast<short>(maxX - minX + 1);
+            glyph.height = static_cast<short>(maxY - minY + 1);
+            glyph.u0 = (x0 + minX) / static_cast<float>(GLYPH_ATLAS_WIDTH);
+            glyph.v0 = (y0 + minY) / static_cast<float>(GLYPH_ATLAS_HEIGHT);
+            glyph.u1 = (x0 + maxX + 1) / static_cast<float>(GLYPH_ATLAS_WIDTH);
+            glyph.v1 = (y0 + maxY + 1) / static_cast<float>(GLYPH_ATLAS_HEIGHT);
+        }
+    }
+
+    glGenTextures(1, &atlasTexture);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, GLYPH_ATLAS_WIDTH, GLYPH_ATLAS_HEIGHT, 0,
+                 GL_ALPHA, GL_UNSIGNED_BYTE, &coverage[0]);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return glGetError() == GL_NO_ERROR;
+}
+
+void TextRenderer::layout(FontFace face, int x, int y, const char* str, const unsigned char rgb[3],
+                          std::vector<TextVertex>& out) const {
+    int pen = x;
+    for (const char* c = str; *c; ++c) {
+        int code = static_cast<unsigned char>(*c);
+        if (code < FIRST_GLYPH || code > LAST_GLYPH) code = '?';
+        const Glyph& g = glyphs[face][code - FIRST_GLYPH];
+        if (g.width > 0) {
+            float x0 = static_cast<float>(pen + g.left);
+            float y0 = static_cast<float>(y + g.bottom);
+            float x1 = x0 + g.width;
+            float y1 = y0 + g.height;
+            TextVertex quad[4] = {
+                {x0, y0, g.u0, g.v0, rgb[0], rgb[1], rgb[2], 255},
+                {x1, y0, g.u1, g.v0, rgb[0], rgb[1], rgb[2], 255},
+                {x1, y1, g.u1, g.v1, rgb[0], rgb[1], rgb[2], 255},
+                {x0, y1, g.u0, g.v1, rgb[0], rgb[1], rgb[2], 255}
+            };
+            out.insert(out.end(), quad, quad + 4);
+        }
+        pen += g.advance;
+    }
+}
+
+int TextRenderer::width(FontFace face, const char* str) const {
+    int total = 0;
+    for (const char* c = str; *c; ++c) {
+        int code = static_cast<unsigned char>(*c);
+        if (ready()) {
+            if (code < FIRST_GLYPH || code > LAST_GLYPH) code = '?';
+            total += glyphs[face][code - FIRST_GLYPH].advance;
+        } else {
+            total += glutBitmapWidth(glutFont(face), code);
+        }
+    }
+    return total;
+}
+
+void TextRenderer::drawFallback(FontFace face, int x, int y, const std::string& str,
+                                const unsigned char rgb[3]) const {
+    glColor3ub(rgb[0], rgb[1], rgb[2]);
+    glRasterPos2i(x, y);
+    for (size_t i = 0; i < str.size(); ++i) {
+        glutBitmapCharacter(glutFont(face), str[i]);
+    }
+}
+
+void TextRenderer::queue(const TextLabel& label) {
+    if (!ready() || !label.laidOut) {
+        drawFallback(label.face, label.x, label.y, label.current, label.rgb);
+        return;
+    }
+    batch.insert(batch.end(), label.quads.begin(), label.quads.end());
+}
+
+void TextRenderer::queue(FontFace face, int x, int y, const char* str, const float color[3]) {
+    unsigned char rgb[3];
+    toBytes(color, rgb);
+    if (!ready()) {
+        drawFallback(face, x, y, str, rgb);
+        return;
+    }
+    layout(face, x, y, str, rgb, batch);
+}
+
+void TextRenderer::flush() {
+    if (batch.empty()) return;
+
+    glEnable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, atlasTexture);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, sizeof(TextVertex), &batch[0].x);
+    glTexCoordPointer(2, GL_FLOAT, sizeof(TextVertex), &batch[0].u);
+    glColorPointer(4, GL_UNSIGNED_BYTE, sizeof(TextVertex), &batch[0].r);
+    glDrawArrays(GL_QUADS, 0, static_cast<GLsizei>(batch.size()));
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    glBindTexture(GL_TEXTURE_2D, 0);
+    glDisable(GL_TEXTURE_2D);
+    batch.clear();
+}
@@ -0,0 +1,107 @@
+//
+//  text_renderer.h
+//  Fish-Fillet-Project
+//
+//  Batched bitmap text. The GLUT Helvetica 12 and Times Roman 24 glyphs are
+//  drawn once with glutBitmapCharacter, read back and packed into an alpha
+//  texture; after that a string is a row of textured quads and every queued
+//  string goes out in a single glDrawArrays on flush(). TextLabel keeps the
+//  quads of one HUD field and only lays them out again when its text, place
+//  or colour changes.
+//
+//  If the atlas cannot be built (window smaller than the atlas, missing GL
+//  support) the renderer draws each string with glutBitmapCharacter as
+//  before, so callers never need a second code path.
+//
+
+#ifndef TEXT_RENDERER_H
+#define TEXT_RENDERER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+enum FontFace {
+    FONT_HELVETICA_12 = 0,
+    FONT_TIMES_ROMAN_24 = 1,
+    FONT_COUNT
+};
+
+const int FIRST_GLYPH = 32;   // Printable ASCII only
+const int LAST_GLYPH = 126;
+const int GLYPH_ATLAS_WIDTH = 512;
+const int GLYPH_ATLAS_HEIGHT = 512;
+
+struct TextVertex {
+    float x, y;
+    float u, v;
+    unsigned char r, g, b, a;
+};
+
+class TextRenderer;
+
+class TextLabel {
+public:
+    TextLabel();
+
+    // Lay the label out again only if something about it changed
+    void set(const TextRenderer& text, FontFace face, int x, int y, const char* str,
+             const float color[3]);
+
+    const std::string& text() const { return current; }
+    const std::vector<TextVertex>& vertices() const { return quads; }
+
+private:
+    friend class TextRenderer;
+
+    std::string current;
+    FontFace face;
+    int x, y;
+    unsigned char rgb[3];
+    bool laidOut;                  // Quads match the atlas (false in fallback mode)
+    std::vector<TextVertex> quads;
+};
+
+class TextRenderer {
+public:
+    TextRenderer();
+
+    // Build the atlas. Needs a current GLUT window whose back buffer covers
+    // the atlas; safe to call every frame, only the first call does work.
+    // Clobbers the colour buffer, so call it before clearing for a frame.
+    void init();
+    bool ready() const { return atlasTexture != 0; }
+
+    // Quads for str with its baseline starting at (x, y), appended to out
+    void layout(FontFace face, int x, int y, const char* str, const unsigned char rgb[3],
+                std::vector<TextVertex>& out) const;
+
+    // Pixel width of str, as glutBitmapLength would report it
+    int width(FontFace face, const char* str) const;
+
+    // Queue text for the next flush()
+    void queue(const TextLabel& label);
+    void queue(FontFace face, int x, int y, const char* str, const float color[3]);
+
+    // Draw everything queued since the last flush in one call
+    void flush();
+
+private:
+    struct Glyph {
+        short advance;                 // glutBitmapWidth
+        short left, bottom;            // Quad offset from the pen position
+        short width, height;           // Quad size in pixels (0 for blank glyphs)
+        float u0, v0, u1, v1;
+    };
+
+    bool attempted;
+    unsigned int atlasTexture;
+    Glyph glyphs[FONT_COUNT][LAST_GLYPH - FIRST_GLYPH + 1];
+    std::vector<TextVertex> batch;
+
+    bool buildAtlas();
+    void drawFallback(FontFace face, int x, int y, const std::string& str,
+                      const unsigned char rgb[3]) const;
+};
+
+#endif // TEXT_RENDERER_H
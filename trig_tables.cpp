@@ -0,0 +1,59 @@
+//
+//  trig_tables.cpp
+//  Fish-Fillet-Project
+//
+
+#include "trig_tables.h"
+#include "game_config.h"
+#include <cmath>
+#include <deque>
+
+struct TableKey {
+    int segments;
+    float startAngle;
+    float span;
+};
+
+struct CachedTable {
+    TableKey key;
+    TrigTable table;
+};
+
+// A deque never moves its elements, so references handed out stay valid
+static std::deque<CachedTable>& tableCache() {
+    static std::deque<CachedTable> cache;
+    return cache;
+}
+
+const TrigTable& arcTable(int segments, float startAngle, float span) {
+    std::deque<CachedTable>& cache = tableCache();
+    for (size_t i = 0; i < cache.size(); ++i) {
+        const TableKey& k = cache[i].key;
+        if (k.segments == segments && k.startAngle == startAngle && k.span == span) {
+            return cache[i].table;
+        }
+    }
+
+    CachedTable entry;
+    entry.key.segments = segments;
+    entry.key.startAngle = startAngle;
+    entry.key.span = span;
+    entry.table.segments = segments;
+    entry.table.cosv.resize(segments + 1);
+    entry.table.sinv.resize(segments + 1);
+    for (int i = 0; i <= segments; ++i) {
+        float angle = span * float(i) / float(segments) + startAngle;
+        entry.table.cosv[i] = std::cos(angle);
+        entry.table.sinv[i] = std::sin(angle);
+    }
+    cache.push_back(entry);
+    return cache.back().table;
+}
+
+const TrigTable& circleTable(int segments) {
+    return arcTable(segments, 0.0f, 2.0f * PI);
+}
+
+const TrigTable& halfCircleTable(int segments) {
+    return arcTable(segments, 0.0f, PI);
+}
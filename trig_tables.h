@@ -0,0 +1,35 @@
+//
+//  trig_tables.h
+//  Fish-Fillet-Project
+//
+//  Precomputed cos/sin for the fixed-angle shapes (waves, fish outline,
+//  eyes, tail fan). A table holds segments + 1 samples of an arc, starting
+//  at startAngle and spanning span radians, computed with the same float
+//  expression the shape code used inline so the vertices do not move.
+//
+//  Tables are built on first use and live for the whole program; callers
+//  keep the returned reference (usually in a function-local static) so the
+//  lookup itself never shows up in a frame.
+//
+
+#ifndef TRIG_TABLES_H
+#define TRIG_TABLES_H
+
+#include <vector>
+
+struct TrigTable {
+    int segments;
+    std::vector<float> cosv;  // segments + 1 entries
+    std::vector<float> sinv;
+};
+
+// Arc sample i has angle startAngle + span * i / segments
+const TrigTable& arcTable(int segments, float startAngle, float span);
+
+// Full circle starting at angle 0
+const TrigTable& circleTable(int segments);
+
+// Upper half circle, 0 to PI; scale x and y separately for a half ellipse
+const TrigTable& halfCircleTable(int segments);
+
+#endif // TRIG_TABLES_H
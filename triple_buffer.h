@@ -0,0 +1,52 @@
+//
+//  triple_buffer.h
+//  Fish-Fillet-Project
+//
+//  Lock-free single-producer / single-consumer triple buffer. The writer
+//  fills its back slot and publishes it by swapping it with the middle slot;
+//  the reader takes the middle slot whenever a new one has been published.
+//  Neither side ever waits for the other, the reader always sees the most
+//  recent complete value, and intermediate values may be skipped.
+//
+
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+template <class T>
+class TripleBuffer {
+public:
+    TripleBuffer() : middle(1), back(2), front(0) {}
+
+    // Writer side: the slot to fill, then publish() it
+    T& writeSlot() { return slots[back]; }
+
+    void publish() {
+        back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+    }
+
+    // Reader side: take the newest published slot if there is one.
+    // Returns true when readSlot() changed.
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & FRESH)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+        return true;
+    }
+
+    const T& readSlot() const { return slots[front]; }
+
+private:
+    static const int INDEX = 3;
+    static const int FRESH = 4;   // Set on the middle index until the reader takes it
+
+    T slots[3];
+    std::atomic<int> middle;      // Index of the shared slot, plus FRESH
+    int back;                     // Writer-owned
+    int front;                    // Reader-owned
+
+    TripleBuffer(const TripleBuffer&);
+    TripleBuffer& operator=(const TripleBuffer&);
+};
+
+#endif // TRIPLE_BUFFER_H
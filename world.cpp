@@ -0,0 +1,364 @@
+//
+//  world.cpp
+//  Fish-Fillet-Project
+//
+
+#include "world.h"
+#include "behavior_kernel.h"
+#include "profiler.h"
+#include "swept_collision.h"
+#include <algorithm>
+#include <cmath>
+
+World::World(uint64_t masterSeed)
+    : player(true), grid(WINDOW_WIDTH, OCEAN_HEIGHT), cameraX(0.0f), cameraY(0.0f),
+      level(defaultLevel()), jobs(0), mouseX(WINDOW_WIDTH / 2.0f), mouseY(WINDOW_HEIGHT / 2.0f),
+      scrollingWorld(false), flockGrid(WINDOW_WIDTH, OCEAN_HEIGHT), seedSequence(masterSeed) {
+    reset();
+}
+
+void World::setLevel(const std::shared_ptr<const Level>& newLevel) {
+    level = newLevel;
+    reset(roundSeed);
+}
+
+void World::reset() {
+    reset(nextSeed(seedSequence));
+}
+
+// Cache what the level's rules decide for a whole round
+void World::applyRules() {
+    const LevelRules& rules = level->rules;
+    behavior = behaviorParams(rules);
+    // Farthest apart a player and a fish can be while touching, at maximum sizes
+    maxContactDistance = COLLISION_RADIUS * rules.maxPlayerSize + COLLISION_RADIUS * level->largestScale();
+    scrollingWorld = rules.worldWidth > WINDOW_WIDTH || rules.worldHeight > OCEAN_HEIGHT;
+}
+
+// Fish a round of this level starts with
+size_t World::spawnCount() const {
+    return level->placedCount() > 0 ? level->placedCount() : level->rules.fishCount;
+}
+
+void World::reset(uint64_t seed) {
+    const LevelRules& rules = level->rules;
+    applyRules();
+
+    roundSeed = seed;
+    rng.seed(seed);
+    isGameOver = false;
+    score = 0;
+    gameTime = rules.initialTime;
+    allYellowFishGone = false;
+    playerSizeScale = rules.initialPlayerSize;  // Reset player size
+    prevMouseX = WINDOW_WIDTH / 2.0f;       // Reset previous mouse position
+    tickCount = 0;
+    accumulator = 0.0;
+    ticksIntoSecond = 0;
+    events.clear();
+
+    // A scrolling round opens at the surface, halfway across, with the
+    // player under the mouse. Otherwise the player stays where it was.
+    cameraX = scrollingWorld ? (rules.worldWidth - WINDOW_WIDTH) * 0.5f : 0.0f;
+    cameraY = scrollingWorld ? rules.worldHeight - OCEAN_HEIGHT : 0.0f;
+    if (scrollingWorld) placePlayer();
+    sweepX = player.x;
+    sweepY = player.y;
+
+    size_t fishCount = spawnCount();
+    sizeGrids(fishCount);
+    reserveRound(fishCount);
+    fish.clear();
+    if (level->placedCount() > 0) {
+        // Hand-placed fish start exactly where the level puts them
+        const PlacedFish* placed = level->placed();
+        for (size_t i = 0; i < level->placedCount(); ++i) {
+            const PlacedFish& p = placed[i];
+            fish.push(Fish(p.x, p.y, p.direction, rules.species[p.species].scale, p.isRed != 0, p.species));
+        }
+    } else {
+        for (uint32_t i = 0; i < rules.fishCount; ++i) {
+            Fish f(rng, rules);
+            randomizeFishPositionAway(f);
+            fish.push(f);
+        }
+    }
+
+    if (scrollingWorld) {
+        chunks.reset(rules.worldWidth, rules.worldHeight, fishCount);
+        streamChunks();  // Everything away from the opening view goes to sleep
+    }
+}
+
+// Whether grid already has the cells a grid over width x height would have
+static bool gridFits(const SpatialHash& grid, float width, float height, float cellSize) {
+    return grid.cellSize() == cellSize &&
+           grid.columnCount() == std::max(1, static_cast<int>(std::ceil(width / cellSize))) &&
+           grid.rowCount() == std::max(1, static_cast<int>(std::ceil(height / cellSize)));
+}
+
+// The grids cover the whole ocean, or in a scrolling world the largest
+// awake region, which setOrigin moves along with the view. They are only
+// rebuilt when their shape changes, so a restart does not allocate.
+void World::sizeGrids(size_t fishCount) {
+    const LevelRules& rules = level->rules;
+    float width = rules.worldWidth;
+    float height = rules.worldHeight;
+    if (scrollingWorld) {
+        width = std::min(width, ChunkMap::awakeSpan(WINDOW_WIDTH));
+        height = std::min(height, ChunkMap::awakeSpan(OCEAN_HEIGHT));
+    }
+    if (!gridFits(grid, width, height, SPATIAL_CELL_SIZE)) grid = SpatialHash(width, height);
+    grid.setOrigin(0.0f, 0.0f);
+
+    if (!behavior.flocking) return;
+    float flockCell = flockCellSize(fishCount, rules.worldWidth * rules.worldHeight);
+    if (!gridFits(flockGrid, width, height, flockCell)) flockGrid = SpatialHash(width, height, flockCell);
+    flockGrid.setOrigin(0.0f, 0.0f);
+}
+
+// Size every buffer a round can grow into up front, so ticks never touch
+// the heap. Nothing shrinks, so restarting a level allocates nothing.
+void World::reserveRound(size_t fishCount) {
+    fish.reserve(fishCount);
+    grid.reserve(fishCount);
+    removed.reserve(fishCount);
+    contacts.reserve(fishCount);
+    events.reserve(fishCount + 2);  // Every fish eaten, then how the round ended
+    if (behavior.flocking) {
+        flockGrid.reserve(fishCount);
+        neighbors.resize(fishCount);
+        driftX.reserve(fishCount);
+        driftY.reserve(fishCount);
+    }
+}
+
+void World::mouseMove(float x, float y) {
+    mouseX = x;
+    mouseY = y;
+    placePlayer();
+    if (tickCount == 0) {
+        // Input before a round's first tick places the player; it is not swept
+        sweepX = player.x;
+        sweepY = player.y;
+    }
+}
+
+// Put the player under the mouse, seen through the camera
+void World::placePlayer() {
+    player.move(cameraX + mouseX, cameraY + (WINDOW_HEIGHT - mouseY), prevMouseX);
+    prevMouseX = player.x;
+}
+
+// How far to scroll along one axis this tick: nothing between the edge
+// bands, up to CAMERA_SPEED as the mouse goes deeper into one
+static float edgeScroll(float position, float band, float length) {
+    if (position < band) return -CAMERA_SPEED * std::min(1.0f, (band - position) / band);
+    if (position > length - band) return CAMERA_SPEED * std::min(1.0f, (position - (length - band)) / band);
+    return 0.0f;
+}
+
+// Scroll when the mouse is near an edge; the mouse keeps its place on the
+// screen, so the player travels with the view. Then wake and sleep chunks
+// for the new view.
+void World::scrollView() {
+    const LevelRules& rules = level->rules;
+    cameraX += edgeScroll(mouseX, CAMERA_EDGE_X, WINDOW_WIDTH);
+    cameraY += edgeScroll(WINDOW_HEIGHT - mouseY, CAMERA_EDGE_Y, OCEAN_HEIGHT);
+    cameraX = std::min(std::max(cameraX, 0.0f), rules.worldWidth - WINDOW_WIDTH);
+    cameraY = std::min(std::max(cameraY, 0.0f), rules.worldHeight - OCEAN_HEIGHT);
+    placePlayer();
+    streamChunks();
+}
+
+void World::streamChunks() {
+    chunks.update(fish, cameraX, cameraY, WINDOW_WIDTH, OCEAN_HEIGHT, tickCount);
+    grid.setOrigin(chunks.awakeX(), chunks.awakeY());
+    flockGrid.setOrigin(chunks.awakeX(), chunks.awakeY());
+}
+
+// Ensure fish spawn away from player to avoid unfair instant collisions
+void World::randomizeFishPositionAway(Fish& f) {
+    if (f.isPlayer) return;
+    int attempts = 0;
+    float safeDist2 = SAFE_SPAWN_DISTANCE * SAFE_SPAWN_DISTANCE;
+    while (attempts < 50) {
+        f.x = static_cast<float>(rng.nextInt(static_cast<int>(level->rules.worldWidth) - 100));
+        f.y = static_cast<float>(rng.nextInt(static_cast<int>(level->rules.worldHeight)));
+        float dx = f.x - player.x;
+        float dy = f.y - player.y;
+        if (dx * dx + dy * dy > safeDist2) break;
+        attempts++;
+    }
+}
+
+bool World::checkCollision(size_t i) const {
+    float dx = player.x - fish.x[i];
+    float dy = player.y - fish.y[i];
+    float distanceSquared = dx * dx + dy * dy;
+
+    float combinedRadius = playerRadius() + fish.collisionRadius(i);
+    float collisionDistance = combinedRadius * combinedRadius;
+
+    return distanceSquared < collisionDistance;
+}
+
+bool World::canEatFish(size_t i) const {
+    float otherRadius = fish.collisionRadius(i);
+    return playerRadius() >= otherRadius * 0.95f;  // Slight forgiveness to reduce unfair losses
+}
+
+void World::growPlayer(float amount) {
+    float maxSize = level->rules.maxPlayerSize;
+    if (playerSizeScale < maxSize) {
+        playerSizeScale += amount;
+        if (playerSizeScale > maxSize) {
+            playerSizeScale = maxSize;
+        }
+    }
+}
+
+// Hunters eat the smaller fish they touch. Hunters go in index order and a
+// fish eaten earlier in the tick no longer hunts, so the result does not
+// depend on the order the grid returns candidates in.
+void World::huntPrey() {
+    float largestRadius = COLLISION_RADIUS * level->largestScale();
+    for (size_t i = 0, n = fish.size(); i < n; ++i) {
+        if (removed[i] || !(fish.isRedFish[i] || behavior.chases[fish.species[i]])) continue;
+        float reach = fish.collisionRadius(i) + largestRadius;
+        grid.forEachNear(fish.x[i], fish.y[i], reach, [&](int j, float d2) {
+            if (removed[j] || !canHunt(fish, behavior, i, j)) return;
+            float touch = fish.collisionRadius(i) + fish.collisionRadius(j);
+            if (d2 < touch * touch) removed[j] = 1;
+        });
+    }
+}
+
+void World::endGame(WorldEvent reason) {
+    isGameOver = true;
+    events.push_back(reason);
+}
+
+int World::step(double dt) {
+    accumulator += dt;
+    // Drop time we could never catch up on rather than stalling further
+    const double maxBacklog = MAX_STEPS_PER_FRAME * static_cast<double>(SIM_DT);
+    if (accumulator > maxBacklog) accumulator = maxBacklog;
+
+    int ticks = 0;
+    while (accumulator >= SIM_DT) {
+        tick();
+        accumulator -= SIM_DT;
+        ++ticks;
+    }
+    return ticks;
+}
+
+void World::tick() {
+    ++tickCount;
+    if (isGameOver) return;
+
+    // Game clock
+    if (++ticksIntoSecond >= TICKS_PER_SECOND) {
+        ticksIntoSecond = 0;
+        if (gameTime > 0 && --gameTime == 0) {
+            endGame(EVENT_TIME_UP);
+            return;
+        }
+    }
+
+    if (scrollingWorld) scrollView();
+    moveFish();
+    resolveCollisions();
+}
+
+void World::moveFish() {
+    // Fish react to each other from where they all started the tick
+    if (behavior.flocking) {
+        ProfileScope scope(PHASE_FLOCK);
+        flockGrid.build(fish.x.data(), fish.y.data(), fish.size());
+        updateFlock(fish, flockGrid, behavior, neighbors, driftX, driftY, jobs);
+    }
+
+    // Update every fish in one batched pass
+    ProfileScope scope(PHASE_BEHAVIOR);
+    const float* flockX = behavior.flocking ? driftX.data() : 0;
+    const float* flockY = behavior.flocking ? driftY.data() : 0;
+    updateFishBehavior(fish, player.x, player.y, playerRadius(), behavior, flockX, flockY, rng, jobs);
+}
+
+void World::resolveCollisions() {
+    ProfileScope scope(PHASE_COLLISION);
+    grid.build(fish.x.data(), fish.y.data(), fish.size());
+
+    // The player jumps to the mouse, so sweep its circle from where it ended
+    // the last tick to where it is now. Fish move a few pixels a tick and
+    // are tested where they are now.
+    float sweepDx = player.x - sweepX;
+    float sweepDy = player.y - sweepY;
+    contacts.clear();
+    grid.forEachNearSegment(sweepX, sweepY, player.x, player.y, maxContactDistance,
+                            [this](int index) { contacts.push_back(index); });
+
+    // Take hits in the order the sweep reaches them (ties by index), so the
+    // first fish touched decides whether the player eats or dies. The player
+    // grows as it eats, so the rest are re-timed from that point each round.
+    removed.assign(fish.size(), 0);
+    float now = 0.0f;
+    while (!isGameOver) {
+        int first = -1;
+        float firstTime = 2.0f;
+        for (size_t c = 0; c < contacts.size(); ++c) {
+            int i = contacts[c];
+            float entry, exit;
+            if (removed[i] || !sweepCircle(sweepX, sweepY, sweepDx, sweepDy, fish.x[i], fish.y[i],
+                                           playerRadius() + fish.collisionRadius(i), entry, exit)) {
+                continue;
+            }
+            if (exit < now) continue;  // Only in reach of the grown player, after it passed
+            float t = entry > now ? entry : now;
+            if (t < firstTime || (t == firstTime && i < first)) {
+                first = i;
+                firstTime = t;
+            }
+        }
+        if (first < 0) break;
+        now = firstTime;
+        int i = first;
+
+        if (!canEatFish(i)) {
+            // Red or yellow, a fish bigger than the player ends the round
+            events.push_back(EVENT_PLAYER_HIT);
+            isGameOver = true;
+            break;
+        }
+
+        const LevelRules& rules = level->rules;
+        if (fish.isRedFish[i]) {
+            score += rules.redPoints;  // Bonus points for eating red fish
+            growPlayer(rules.growthIncrement * rules.redGrowthMult);
+        } else {
+            score += rules.species[fish.species[i]].points;
+            growPlayer(rules.growthIncrement);
+        }
+        events.push_back(EVENT_FISH_EATEN);
+        removed[i] = 1;
+    }
+    sweepX = player.x;
+    sweepY = player.y;
+
+    if (behavior.flocking && behavior.huntSpeed > 0.0f) huntPrey();
+
+    // Swap-and-pop from the highest index down: the fish moved into each
+    // hole comes from the tail, which is never still waiting to be removed
+    for (size_t i = removed.size(); i-- > 0; ) {
+        if (removed[i]) fish.remove(i);
+    }
+
+    // Check win condition - all fish (yellow and red) must be collected,
+    // asleep or awake. Both keep their counts, so this is O(1).
+    if (!isGameOver && fish.empty() && (!scrollingWorld || chunks.sleepingFish() == 0)) {
+        allYellowFishGone = true;  // Set to true for win condition
+        endGame(EVENT_GAME_WON);
+    }
+}
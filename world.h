@@ -0,0 +1,135 @@
+//
+//  world.h
+//  Fish-Fillet-Project
+//
+//  Headless game simulation. Nothing in here touches GL or GLUT, so a
+//  World can be stepped on machines without a display.
+//
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "chunk_map.h"
+#include "fish_store.h"
+#include "flocking.h"
+#include "level.h"
+#include "spatial_hash.h"
+#include <memory>
+#include <vector>
+
+// Things that happened during a tick which the front end may react to
+enum WorldEvent {
+    EVENT_FISH_EATEN = 0,   // Player ate a fish
+    EVENT_PLAYER_HIT = 1,   // Player touched a fish it could not eat
+    EVENT_GAME_WON = 2,     // Every fish has been eaten
+    EVENT_TIME_UP = 3       // Game clock reached zero
+};
+
+class JobSystem;
+
+class World {
+public:
+    Fish player;
+    FishStore fish;         // Every non-player fish, structure-of-arrays
+    SpatialHash grid;       // Broad phase over fish positions, rebuilt each tick
+    ChunkMap chunks;        // Sleeping fish of a scrolling world; unused otherwise
+
+    bool isGameOver;
+    int score;
+    int gameTime;
+    bool allYellowFishGone;
+    float playerSizeScale;  // Player growth scale
+    float prevMouseX;       // Player's previous X, for the direction it faces
+    float cameraX;          // Lower-left corner of the view in the ocean; 0, 0 unless scrolling
+    float cameraY;
+
+    std::shared_ptr<const Level> level;  // Rules and spawns for every round; see setLevel
+    JobSystem* jobs;        // Optional thread pool for large oceans; not owned
+
+    Rng rng;                // All simulation randomness comes from here
+    uint64_t roundSeed;     // Seed the current round was started with
+
+    long tickCount;         // Ticks since the last reset (counted after game over too)
+    std::vector<WorldEvent> events;  // Filled by tick(), drained by the caller
+
+    explicit World(uint64_t masterSeed = 1);
+
+    // Restart the sequence of round seeds that reset() draws from
+    void seedRounds(uint64_t masterSeed) { seedSequence = masterSeed; }
+
+    // Start a fresh round (initial load and the F2 restart) with the next seed
+    void reset();
+
+    // Start a fresh round from a specific seed (replays, reproductions)
+    void reset(uint64_t seed);
+
+    // Switch levels and restart the current round's seed under the new rules
+    void setLevel(const std::shared_ptr<const Level>& newLevel);
+
+    // Feed a mouse position in window coordinates
+    void mouseMove(float mouseX, float mouseY);
+
+    // Whether the level's ocean is bigger than the window
+    bool scrolling() const { return scrollingWorld; }
+
+    // Advance by real elapsed seconds using a fixed timestep; returns ticks run
+    int step(double dt);
+
+    // Advance exactly one fixed timestep
+    void tick();
+
+    // The two halves of a tick after the game clock, public so benchmarks
+    // can time them apart: flocking and behavior, then eating and winning
+    void moveFish();
+    void resolveCollisions();
+
+    // Fraction of a tick left in the accumulator, for render interpolation
+    float interpolationAlpha() const {
+        return static_cast<float>(accumulator / SIM_DT);
+    }
+
+    float playerRadius() const {
+        return COLLISION_RADIUS * playerSizeScale;
+    }
+
+    // Collision Detection - uses size-based radii, at rest
+    bool checkCollision(size_t i) const;
+
+    // Check if player can eat fish i (player must be larger)
+    bool canEatFish(size_t i) const;
+
+private:
+    friend class WorldState;  // Saves and restores the private state below
+
+    double accumulator;
+    int ticksIntoSecond;
+    float sweepX, sweepY;       // Player position at the end of the last tick
+    float mouseX, mouseY;       // Last mouse position, in window coordinates
+    bool scrollingWorld;
+    std::vector<int> contacts;  // Scratch: fish the player's sweep may reach this tick
+    std::vector<unsigned char> removed;  // Scratch: fish eaten this tick, by index
+
+    SpatialHash flockGrid;      // Finer grid for neighbor queries, sized per round
+    NeighborCache neighbors;    // Rebuilt every tick when the level flocks
+    std::vector<float> driftX;  // Per-fish drift from schooling and hunting
+    std::vector<float> driftY;
+
+    uint64_t seedSequence;
+
+    BehaviorParams behavior;    // Cached from level->rules
+    float maxContactDistance;   // Farthest apart a player and fish can touch
+
+    void applyRules();
+    size_t spawnCount() const;
+    void reserveRound(size_t fishCount);
+    void sizeGrids(size_t fishCount);
+    void placePlayer();
+    void scrollView();
+    void streamChunks();
+    void randomizeFishPositionAway(Fish& f);
+    void growPlayer(float amount);
+    void huntPrey();
+    void endGame(WorldEvent reason);
+};
+
+#endif // WORLD_H
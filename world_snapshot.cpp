@@ -0,0 +1,107 @@
+//
+//  world_snapshot.cpp
+//  Fish-Fillet-Project
+//
+
+#include "world_snapshot.h"
+#include "world.h"
+#include <cmath>
+#include <cstring>
+
+WorldSnapshot::WorldSnapshot()
+    : tickCount(0), roundSeed(0), isGameOver(false), allYellowFishGone(false),
+      score(0), gameTime(0), playerSizeScale(INITIAL_PLAYER_SIZE),
+      playerX(0.0f), playerY(0.0f), playerDirection(FISH_SPEED),
+      cameraX(0.0f), cameraY(0.0f), worldWidth(WINDOW_WIDTH), worldHeight(OCEAN_HEIGHT),
+      awakeChunks(0), chunkCount(0), sleepingFish(0) {
+    std::memset(speciesColor, 0, sizeof(speciesColor));
+}
+
+void WorldSnapshot::capture(const World& world) {
+    tickCount = world.tickCount;
+    roundSeed = world.roundSeed;
+    isGameOver = world.isGameOver;
+    allYellowFishGone = world.allYellowFishGone;
+    score = world.score;
+    gameTime = world.gameTime;
+    playerSizeScale = world.playerSizeScale;
+    playerX = world.player.x;
+    playerY = world.player.y;
+    playerDirection = world.player.direction;
+    cameraX = world.cameraX;
+    cameraY = world.cameraY;
+    worldWidth = world.level->rules.worldWidth;
+    worldHeight = world.level->rules.worldHeight;
+    awakeChunks = world.scrolling() ? world.chunks.awakeCount() : 0;
+    chunkCount = world.scrolling() ? world.chunks.chunkCount() : 0;
+    sleepingFish = world.scrolling() ? world.chunks.sleepingFish() : 0;
+
+    const FishStore& fish = world.fish;
+    if (x.capacity() < fish.capacity()) reserve(fish.capacity());
+    x.assign(fish.x.begin(), fish.x.end());
+    y.assign(fish.y.begin(), fish.y.end());
+    direction.assign(fish.direction.begin(), fish.direction.end());
+    sizeScale.assign(fish.sizeScale.begin(), fish.sizeScale.end());
+    isRedFish.assign(fish.isRedFish.begin(), fish.isRedFish.end());
+    species.assign(fish.species.begin(), fish.species.end());
+    id.assign(fish.id.begin(), fish.id.end());
+    generation.resize(fish.size());
+    for (size_t i = 0; i < fish.size(); ++i) generation[i] = fish.handle(i).generation;
+
+    const LevelRules& rules = world.level->rules;
+    for (int s = 0; s < rules.speciesCount; ++s) {
+        std::memcpy(speciesColor[s], rules.species[s].color, sizeof(speciesColor[s]));
+    }
+}
+
+void WorldSnapshot::reserve(size_t fishCount) {
+    x.reserve(fishCount);
+    y.reserve(fishCount);
+    direction.reserve(fishCount);
+    sizeScale.reserve(fishCount);
+    isRedFish.reserve(fishCount);
+    species.reserve(fishCount);
+    id.reserve(fishCount);
+    generation.reserve(fishCount);
+}
+
+static inline bool blendable(float a, float b) {
+    return std::fabs(b - a) <= MAX_BLEND_DISTANCE;
+}
+
+void WorldSnapshot::blend(const WorldSnapshot& from, const WorldSnapshot& to, float alpha,
+                          std::vector<int>& slotScratch) {
+    *this = to;
+    if (alpha >= 1.0f || from.roundSeed != to.roundSeed || from.tickCount >= to.tickCount) return;
+    if (alpha < 0.0f) alpha = 0.0f;
+
+    if (blendable(from.playerX, to.playerX) && blendable(from.playerY, to.playerY)) {
+        playerX = from.playerX + (to.playerX - from.playerX) * alpha;
+        playerY = from.playerY + (to.playerY - from.playerY) * alpha;
+    }
+    if (blendable(from.cameraX, to.cameraX) && blendable(from.cameraY, to.cameraY)) {
+        cameraX = from.cameraX + (to.cameraX - from.cameraX) * alpha;
+        cameraY = from.cameraY + (to.cameraY - from.cameraY) * alpha;
+    }
+
+    // Swap-and-pop reorders fish between snapshots; find each one by slot
+    uint32_t slots = 0;
+    for (size_t j = 0; j < from.id.size(); ++j) {
+        if (from.id[j] + 1 > slots) slots = from.id[j] + 1;
+    }
+    slotScratch.assign(slots, -1);
+    for (size_t j = 0; j < from.id.size(); ++j) {
+        slotScratch[from.id[j]] = static_cast<int>(j);
+    }
+
+    for (size_t i = 0; i < id.size(); ++i) {
+        if (id[i] >= slots) continue;
+        int j = slotScratch[id[i]];
+        if (j < 0 || from.generation[j] != generation[i] || !blendable(from.x[j], x[i]) ||
+            !blendable(from.y[j], y[i])) {
+            continue;
+        }
+        x[i] = from.x[j] + (x[i] - from.x[j]) * alpha;
+        y[i] = from.y[j] + (y[i] - from.y[j]) * alpha;
+    }
+}
@@ -0,0 +1,71 @@
+//
+//  world_snapshot.h
+//  Fish-Fillet-Project
+//
+//  Everything the renderer needs from a World after one tick, copied out so
+//  the simulation can keep running while a frame is drawn. Snapshots own
+//  their arrays; capturing into a snapshot that was used before reuses its
+//  storage, so steady-state publishing does not allocate.
+//
+
+#ifndef WORLD_SNAPSHOT_H
+#define WORLD_SNAPSHOT_H
+
+#include "level.h"
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+class World;
+
+// Farthest a fish may move between two snapshots and still be blended;
+// anything further wrapped around the screen or respawned
+const float MAX_BLEND_DISTANCE = 100.0f;
+
+struct WorldSnapshot {
+    std::chrono::steady_clock::time_point time;  // When the tick was scheduled to run
+    long tickCount;
+    uint64_t roundSeed;
+
+    bool isGameOver;
+    bool allYellowFishGone;
+    int score;
+    int gameTime;
+    float playerSizeScale;
+
+    float playerX, playerY, playerDirection;
+
+    // View into the ocean and how much of it is streamed in (chunk_map.h)
+    float cameraX, cameraY;
+    float worldWidth, worldHeight;
+    int awakeChunks, chunkCount;
+    size_t sleepingFish;
+
+    // Fish in FishStore order, with the store's handles for matching: a
+    // slot freed by one fish and reused by another has a new generation
+    std::vector<float> x, y, direction, sizeScale;
+    std::vector<unsigned char> isRedFish, species;
+    std::vector<uint32_t> id, generation;
+
+    float speciesColor[MAX_SPECIES][3];  // From the level, indexed by species
+
+    WorldSnapshot();
+
+    size_t fishCount() const { return x.size(); }
+
+    // Copy the world's state. The arrays grow to the store's capacity, so
+    // later rounds of the same level copy without allocating.
+    void capture(const World& world);
+
+    void reserve(size_t fishCount);
+
+    // This snapshot becomes `to` with positions pulled back toward `from`
+    // by (1 - alpha). Fish are matched by handle (slot id and generation);
+    // fish that jumped, new fish, or a different round are taken from `to`
+    // unchanged. slotScratch is reused
+    // between calls to avoid allocating.
+    void blend(const WorldSnapshot& from, const WorldSnapshot& to, float alpha,
+               std::vector<int>& slotScratch);
+};
+
+#endif // WORLD_SNAPSHOT_H
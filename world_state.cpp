@@ -0,0 +1,402 @@
+//
+//  world_state.cpp
+//  Fish-Fillet-Project
+//
+
+#include "world_state.h"
+#include "world.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+static const char STATE_MAGIC[8] = {'F', 'I', 'S', 'H', 'S', 'A', 'V', '\0'};
+
+static_assert(MAX_SPECIES <= 8, "a fish's species must fit the low 3 bits of its flags");
+const unsigned char FLAG_SPECIES = 0x07;
+const unsigned char FLAG_RED = 0x80;
+
+// Byte offsets of each part of a state holding n awake and m sleeping fish
+struct StateLayout {
+    size_t rules;
+    size_t x, y, direction, flags;
+    size_t sleptAt, chunk, sleepX, sleepY, sleepDirection, sleepFlags;
+    size_t total;
+};
+
+static size_t align16(size_t offset) {
+    return (offset + 15) & ~static_cast<size_t>(15);
+}
+
+static StateLayout layoutFor(size_t n, size_t m) {
+    StateLayout l;
+    l.rules = sizeof(WorldStateHeader);
+    l.x = align16(l.rules + sizeof(LevelRules));
+    l.y = align16(l.x + n * sizeof(float));
+    l.direction = align16(l.y + n * sizeof(float));
+    l.flags = align16(l.direction + n * sizeof(float));
+    l.sleptAt = align16(l.flags + n);
+    l.chunk = align16(l.sleptAt + m * sizeof(int64_t));
+    l.sleepX = align16(l.chunk + m * sizeof(uint32_t));
+    l.sleepY = align16(l.sleepX + m * sizeof(float));
+    l.sleepDirection = align16(l.sleepY + m * sizeof(float));
+    l.sleepFlags = align16(l.sleepDirection + m * sizeof(float));
+    l.total = align16(l.sleepFlags + m);
+    return l;
+}
+
+static unsigned char packFlags(int species, bool isRed) {
+    return static_cast<unsigned char>((species & FLAG_SPECIES) | (isRed ? FLAG_RED : 0));
+}
+
+// Clear the gap an array leaves before the next one, so equal states are
+// equal byte for byte
+static void padTo(unsigned char* out, size_t end, size_t next) {
+    std::memset(out + end, 0, next - end);
+}
+
+void WorldState::capture(const World& world) {
+    const FishStore& fish = world.fish;
+    size_t n = fish.size();
+    size_t m = world.scrollingWorld ? world.chunks.sleepingFish() : 0;
+    StateLayout l = layoutFor(n, m);
+    bytes.resize(l.total);
+    unsigned char* out = &bytes[0];
+
+    WorldStateHeader h;
+    std::memset(&h, 0, sizeof(h));
+    std::memcpy(h.magic, STATE_MAGIC, sizeof(STATE_MAGIC));
+    h.version = WORLD_STATE_VERSION;
+    h.headerBytes = sizeof(WorldStateHeader);
+    h.rulesBytes = sizeof(LevelRules);
+    h.flags = (world.isGameOver ? STATE_GAME_OVER : 0) | (world.allYellowFishGone ? STATE_ALL_EATEN : 0);
+    h.roundSeed = world.roundSeed;
+    h.seedSequence = world.seedSequence;
+    h.rngState = world.rng.rawState();
+    h.tickCount = world.tickCount;
+    h.accumulator = world.accumulator;
+    h.fishCount = static_cast<uint32_t>(n);
+    h.sleepingCount = static_cast<uint32_t>(m);
+    h.spawnCount = static_cast<uint32_t>(world.spawnCount());
+    h.score = world.score;
+    h.gameTime = world.gameTime;
+    h.ticksIntoSecond = world.ticksIntoSecond;
+    h.playerSizeScale = world.playerSizeScale;
+    h.playerX = world.player.x;
+    h.playerY = world.player.y;
+    h.playerDirection = world.player.direction;
+    h.prevMouseX = world.prevMouseX;
+    h.sweepX = world.sweepX;
+    h.sweepY = world.sweepY;
+    h.mouseX = world.mouseX;
+    h.mouseY = world.mouseY;
+    h.cameraX = world.cameraX;
+    h.cameraY = world.cameraY;
+    world.chunks.awakeRegion(h.awakeMinCol, h.awakeMaxCol, h.awakeMinRow, h.awakeMaxRow);
+    std::memcpy(out, &h, sizeof(h));
+    std::memcpy(out + l.rules, &world.level->rules, sizeof(LevelRules));
+    padTo(out, l.rules + sizeof(LevelRules), l.x);
+
+    if (n > 0) {
+        std::memcpy(out + l.x, fish.x.data(), n * sizeof(float));
+        std::memcpy(out + l.y, fish.y.data(), n * sizeof(float));
+        std::memcpy(out + l.direction, fish.direction.data(), n * sizeof(float));
+        unsigned char* flags = out + l.flags;
+        const unsigned char* species = fish.species.data();
+        const unsigned char* red = fish.isRedFish.data();
+        for (size_t i = 0; i < n; ++i) flags[i] = packFlags(species[i], red[i] != 0);
+    }
+    padTo(out, l.x + n * sizeof(float), l.y);
+    padTo(out, l.y + n * sizeof(float), l.direction);
+    padTo(out, l.direction + n * sizeof(float), l.flags);
+    padTo(out, l.flags + n, l.sleptAt);
+
+    if (m > 0) {
+        size_t k = 0;
+        world.chunks.forEachSleeping([&](int chunk, const Fish& f, long tick) {
+            int64_t sleptAt = tick;
+            uint32_t chunkIndex = static_cast<uint32_t>(chunk);
+            std::memcpy(out + l.sleptAt + k * sizeof(int64_t), &sleptAt, sizeof(sleptAt));
+            std::memcpy(out + l.chunk + k * sizeof(uint32_t), &chunkIndex, sizeof(chunkIndex));
+            std::memcpy(out + l.sleepX + k * sizeof(float), &f.x, sizeof(float));
+            std::memcpy(out + l.sleepY + k * sizeof(float), &f.y, sizeof(float));
+            std::memcpy(out + l.sleepDirection + k * sizeof(float), &f.direction, sizeof(float));
+            out[l.sleepFlags + k] = packFlags(f.species, f.isRedFish);
+            ++k;
+        });
+    }
+    padTo(out, l.sleptAt + m * sizeof(int64_t), l.chunk);
+    padTo(out, l.chunk + m * sizeof(uint32_t), l.sleepX);
+    padTo(out, l.sleepX + m * sizeof(float), l.sleepY);
+    padTo(out, l.sleepY + m * sizeof(float), l.sleepDirection);
+    padTo(out, l.sleepDirection + m * sizeof(float), l.sleepFlags);
+    padTo(out, l.sleepFlags + m, l.total);
+}
+
+bool WorldState::restore(World& world, std::string& error) const {
+    if (bytes.empty()) {
+        error = "no state to restore";
+        return false;
+    }
+    const unsigned char* in = &bytes[0];
+    WorldStateHeader h = header();
+    StateLayout l = layoutFor(h.fishCount, h.sleepingCount);
+    if (std::memcmp(in + l.rules, &world.level->rules, sizeof(LevelRules)) != 0) {
+        error = "the state was saved under different level rules";
+        return false;
+    }
+    if (h.spawnCount != world.spawnCount()) {
+        error = "the state was saved on a level with another number of fish";
+        return false;
+    }
+
+    // Round-wide settings and buffers, as reset() makes them, sized for the
+    // fish the round started with so the grids and flocking cells match
+    world.applyRules();
+    world.sizeGrids(h.spawnCount);
+    world.reserveRound(h.spawnCount);
+
+    world.roundSeed = h.roundSeed;
+    world.seedSequence = h.seedSequence;
+    world.rng.setRawState(h.rngState);
+    world.tickCount = static_cast<long>(h.tickCount);
+    world.accumulator = h.accumulator;
+    world.isGameOver = (h.flags & STATE_GAME_OVER) != 0;
+    world.allYellowFishGone = (h.flags & STATE_ALL_EATEN) != 0;
+    world.score = h.score;
+    world.gameTime = h.gameTime;
+    world.ticksIntoSecond = h.ticksIntoSecond;
+    world.playerSizeScale = h.playerSizeScale;
+    world.player.x = h.playerX;
+    world.player.y = h.playerY;
+    world.player.direction = h.playerDirection;
+    world.prevMouseX = h.prevMouseX;
+    world.sweepX = h.sweepX;
+    world.sweepY = h.sweepY;
+    world.mouseX = h.mouseX;
+    world.mouseY = h.mouseY;
+    world.cameraX = h.cameraX;
+    world.cameraY = h.cameraY;
+    world.events.clear();
+
+    const LevelRules& rules = world.level->rules;
+    size_t n = h.fishCount;
+    FishStore& fish = world.fish;
+    fish.resize(n);
+    if (n > 0) {
+        std::memcpy(fish.x.data(), in + l.x, n * sizeof(float));
+        std::memcpy(fish.y.data(), in + l.y, n * sizeof(float));
+        std::memcpy(fish.direction.data(), in + l.direction, n * sizeof(float));
+        // Through plain pointers: byte stores could alias the vectors
+        const unsigned char* flags = in + l.flags;
+        unsigned char* species = fish.species.data();
+        unsigned char* red = fish.isRedFish.data();
+        float* sizeScale = fish.sizeScale.data();
+        float scales[FLAG_SPECIES + 1] = {0.0f};
+        for (int s = 0; s < rules.speciesCount; ++s) scales[s] = rules.species[s].scale;
+        for (size_t i = 0; i < n; ++i) {
+            species[i] = flags[i] & FLAG_SPECIES;
+            red[i] = flags[i] >> 7;
+            sizeScale[i] = scales[flags[i] & FLAG_SPECIES];
+        }
+    }
+
+    if (world.scrollingWorld) {
+        // Sleep in reverse so every chunk's list comes back in its old order,
+        // and chunks wake their fish into the store in the same order
+        ChunkMap& chunks = world.chunks;
+        chunks.reset(rules.worldWidth, rules.worldHeight, h.spawnCount);
+        for (size_t k = h.sleepingCount; k-- > 0; ) {
+            int64_t sleptAt;
+            uint32_t chunk;
+            float x, y, direction;
+            std::memcpy(&sleptAt, in + l.sleptAt + k * sizeof(int64_t), sizeof(sleptAt));
+            std::memcpy(&chunk, in + l.chunk + k * sizeof(uint32_t), sizeof(chunk));
+            std::memcpy(&x, in + l.sleepX + k * sizeof(float), sizeof(float));
+            std::memcpy(&y, in + l.sleepY + k * sizeof(float), sizeof(float));
+            std::memcpy(&direction, in + l.sleepDirection + k * sizeof(float), sizeof(float));
+            unsigned char flags = in[l.sleepFlags + k];
+            int species = flags & FLAG_SPECIES;
+            chunks.putToSleep(static_cast<int>(chunk),
+                              Fish(x, y, direction, rules.species[species].scale, (flags & FLAG_RED) != 0, species),
+                              static_cast<long>(sleptAt));
+        }
+        chunks.setAwakeRegion(h.awakeMinCol, h.awakeMaxCol, h.awakeMinRow, h.awakeMaxRow);
+        world.grid.setOrigin(chunks.awakeX(), chunks.awakeY());
+        world.flockGrid.setOrigin(chunks.awakeX(), chunks.awakeY());
+    }
+    return true;
+}
+
+WorldStateHeader WorldState::header() const {
+    WorldStateHeader h;
+    std::memset(&h, 0, sizeof(h));
+    if (bytes.size() >= sizeof(h)) std::memcpy(&h, &bytes[0], sizeof(h));
+    return h;
+}
+
+LevelRules WorldState::rules() const {
+    LevelRules r;
+    std::memset(&r, 0, sizeof(r));
+    if (bytes.size() >= sizeof(WorldStateHeader) + sizeof(r)) {
+        std::memcpy(&r, &bytes[sizeof(WorldStateHeader)], sizeof(r));
+    }
+    return r;
+}
+
+void WorldState::reserve(size_t spawnCount) {
+    // Awake or asleep, a round never holds more fish than it started with
+    bytes.reserve(layoutFor(spawnCount, spawnCount).total);
+}
+
+bool WorldState::save(const char* path, std::string& error) const {
+    std::FILE* f = std::fopen(path, "wb");
+    if (!f) {
+        error = std::string("cannot write ") + path;
+        return false;
+    }
+    bool ok = bytes.empty() || std::fwrite(&bytes[0], 1, bytes.size(), f) == bytes.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) error = std::string("failed writing ") + path;
+    return ok;
+}
+
+bool WorldState::load(const char* path, std::string& error) {
+    bytes.clear();
+    std::FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        error = std::string("cannot open ") + path;
+        return false;
+    }
+    unsigned char buffer[65536];
+    size_t got;
+    while ((got = std::fread(buffer, 1, sizeof(buffer), f)) > 0) bytes.insert(bytes.end(), buffer, buffer + got);
+    std::fclose(f);
+    if (!validate(error)) {
+        error = std::string(path) + ": " + error;
+        bytes.clear();
+        return false;
+    }
+    return true;
+}
+
+// Everything restore() relies on, for states that come from a file
+bool WorldState::validate(std::string& error) const {
+    WorldStateHeader h = header();
+    if (bytes.size() < sizeof(h) || std::memcmp(h.magic, STATE_MAGIC, sizeof(STATE_MAGIC)) != 0) {
+        error = "not a fish save state";
+        return false;
+    }
+    if (h.version != WORLD_STATE_VERSION || h.headerBytes != sizeof(WorldStateHeader) ||
+        h.rulesBytes != sizeof(LevelRules)) {
+        error = "saved by a different version of the game";
+        return false;
+    }
+    StateLayout l = layoutFor(h.fishCount, h.sleepingCount);
+    if (bytes.size() < l.rules + sizeof(LevelRules) || bytes.size() != l.total) {
+        error = "state is truncated or corrupt";
+        return false;
+    }
+    LevelRules r = rules();
+    if (r.speciesCount < 1 || r.speciesCount > MAX_SPECIES ||
+        static_cast<uint64_t>(h.fishCount) + h.sleepingCount > h.spawnCount) {
+        error = "state is truncated or corrupt";
+        return false;
+    }
+    int cols = std::max(1, static_cast<int>(std::ceil(r.worldWidth / CHUNK_SIZE)));
+    int rows = std::max(1, static_cast<int>(std::ceil(r.worldHeight / CHUNK_SIZE)));
+    uint32_t chunkCount = static_cast<uint32_t>(cols) * static_cast<uint32_t>(rows);
+    // Scrolling worlds restore their awake chunks; those must lie on the
+    // grid, or be none at all as after a reset
+    bool scrolling = r.worldWidth > WINDOW_WIDTH || r.worldHeight > OCEAN_HEIGHT;
+    bool noneAwake = h.awakeMinCol == 0 && h.awakeMaxCol == -1 && h.awakeMinRow == 0 && h.awakeMaxRow == -1;
+    if (scrolling && !noneAwake && (h.awakeMinCol < 0 || h.awakeMinCol > h.awakeMaxCol || h.awakeMaxCol >= cols ||
+                       h.awakeMinRow < 0 || h.awakeMinRow > h.awakeMaxRow || h.awakeMaxRow >= rows)) {
+        error = "the awake chunks are out of range";
+        return false;
+    }
+    const unsigned char* in = &bytes[0];
+    for (size_t i = 0; i < h.fishCount; ++i) {
+        if ((in[l.flags + i] & FLAG_SPECIES) >= r.speciesCount) {
+            error = "a fish uses a species the rules do not define";
+            return false;
+        }
+    }
+    for (size_t k = 0; k < h.sleepingCount; ++k) {
+        uint32_t chunk;
+        std::memcpy(&chunk, in + l.chunk + k * sizeof(uint32_t), sizeof(chunk));
+        if ((in[l.sleepFlags + k] & FLAG_SPECIES) >= r.speciesCount || chunk >= chunkCount) {
+            error = "a sleeping fish is out of range";
+            return false;
+        }
+    }
+    return true;
+}
+
+StateHistory::StateHistory() : first(0), count(0), roundSeed(0), lastTick(0), newest(0) {}
+
+void StateHistory::clear() {
+    newest.store(0, std::memory_order_release);
+    first = 0;
+    count = 0;
+}
+
+// Checkpoints belong to one round: a restart, a level reload or any other
+// jump back in time starts a new history
+void StateHistory::followRound(const World& world) {
+    if (world.roundSeed != roundSeed || world.tickCount < lastTick) {
+        clear();
+        for (int c = 0; c < REWIND_CHECKPOINTS; ++c) checkpoints[c].reserve(world.fish.capacity());
+    }
+    roundSeed = world.roundSeed;
+    lastTick = world.tickCount;
+}
+
+void StateHistory::afterTick(const World& world) {
+    followRound(world);
+    if (world.isGameOver || world.tickCount % CHECKPOINT_TICKS != 0) return;
+
+    // Write over the oldest slot, never the newest, so a crash dump reading
+    // the newest meanwhile sees a whole state
+    int slot;
+    if (count < REWIND_CHECKPOINTS) {
+        slot = (first + count) % REWIND_CHECKPOINTS;
+        ++count;
+    } else {
+        slot = first;
+        first = (first + 1) % REWIND_CHECKPOINTS;
+    }
+    checkpoints[slot].capture(world);
+    newest.store(&checkpoints[slot], std::memory_order_release);
+}
+
+void StateHistory::save(const World& world) {
+    quickSave.capture(world);
+}
+
+bool StateHistory::load(World& world, std::string& error) {
+    if (!quickSave.restore(world, error)) return false;
+    // The checkpoints may be from another round or from after the save
+    clear();
+    roundSeed = world.roundSeed;
+    lastTick = world.tickCount;
+    return true;
+}
+
+void StateHistory::rewind(World& world) {
+    followRound(world);
+    std::string error;
+    for (int k = count; k-- > 0; ) {
+        int slot = (first + k) % REWIND_CHECKPOINTS;
+        if (checkpoints[slot].header().tickCount > world.tickCount - REWIND_MIN_AGE) continue;
+        if (!checkpoints[slot].restore(world, error)) break;
+        count = k + 1;
+        newest.store(&checkpoints[slot], std::memory_order_release);
+        lastTick = world.tickCount;
+        return;
+    }
+    world.reset(world.roundSeed);
+    clear();
+    roundSeed = world.roundSeed;
+    lastTick = world.tickCount;
+}
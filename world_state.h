@@ -0,0 +1,151 @@
+//
+//  world_state.h
+//  Fish-Fillet-Project
+//
+//  Save states: everything a World needs to carry on from a tick exactly as
+//  if it had never stopped, in one flat buffer. The buffer is the file
+//  format, so capturing is a handful of bulk copies into storage that is
+//  reused from one capture to the next, restoring is the same copies back
+//  out, and saving writes the buffer as it is.
+//
+//  Layout (native byte order, like compiled levels; the loader rejects
+//  other versions and struct sizes):
+//    WorldStateHeader                       counters, clocks, player, camera
+//    LevelRules                             rules the state was played under
+//    awake fish, each array 16-byte aligned:
+//      f32 x[n], f32 y[n], f32 direction[n], u8 flags[n]
+//    sleeping fish (scrolling worlds), per chunk in list order:
+//      i64 sleptAt[m], u32 chunk[m], f32 x[m], f32 y[m], f32 direction[m],
+//      u8 flags[m]
+//  A fish's flags byte packs its species (low 3 bits) and whether it is red
+//  (top bit); its size comes back from the species table. Positions stay
+//  full floats: a resumed round must tick bit for bit like the original,
+//  which rules out quantizing them.
+//
+//  StateHistory keeps the in-game checkpoints: one every CHECKPOINT_TICKS
+//  for rewinding, plus a quick-save slot.
+//
+
+#ifndef WORLD_STATE_H
+#define WORLD_STATE_H
+
+#include "level.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class World;
+
+const uint32_t WORLD_STATE_VERSION = 1;
+
+// WorldStateHeader::flags
+const uint32_t STATE_GAME_OVER = 1u << 0;
+const uint32_t STATE_ALL_EATEN = 1u << 1;
+
+struct WorldStateHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerBytes;       // sizeof(WorldStateHeader) when written
+    uint32_t rulesBytes;        // sizeof(LevelRules) when written
+    uint32_t flags;
+    uint64_t roundSeed;
+    uint64_t seedSequence;      // Where the next restart draws its seed from
+    uint64_t rngState;
+    int64_t tickCount;
+    double accumulator;
+    uint32_t fishCount;         // Awake fish, in the World's FishStore
+    uint32_t sleepingCount;     // Fish asleep in chunks
+    uint32_t spawnCount;        // Fish the round was sized for; sets the grids
+    int32_t score;
+    int32_t gameTime;
+    int32_t ticksIntoSecond;
+    float playerSizeScale;
+    float playerX, playerY, playerDirection;
+    float prevMouseX;
+    float sweepX, sweepY;
+    float mouseX, mouseY;
+    float cameraX, cameraY;
+    int32_t awakeMinCol, awakeMaxCol, awakeMinRow, awakeMaxRow;
+    uint32_t reserved;
+};
+
+class WorldState {
+public:
+    // Copy the world into this state, reusing its storage
+    void capture(const World& world);
+
+    // Put the world back as it was at capture. The world's level must have
+    // the same rules; tools loading a file can build one with
+    // defaultLevel()->withRules(state.rules(), error).
+    bool restore(World& world, std::string& error) const;
+
+    bool save(const char* path, std::string& error) const;
+
+    // Read and check a saved state; false (with error set) on a missing,
+    // truncated or foreign file
+    bool load(const char* path, std::string& error);
+
+    bool empty() const { return bytes.empty(); }
+    WorldStateHeader header() const;
+    LevelRules rules() const;
+
+    // The serialized state, as save() writes it
+    const unsigned char* data() const { return bytes.empty() ? 0 : &bytes[0]; }
+    size_t byteCount() const { return bytes.size(); }
+
+    // Make room for a round of spawnCount fish so capturing never allocates
+    void reserve(size_t spawnCount);
+
+private:
+    std::vector<unsigned char> bytes;
+
+    bool validate(std::string& error) const;
+};
+
+const long CHECKPOINT_TICKS = TICKS_PER_SECOND;
+const int REWIND_CHECKPOINTS = 10;              // How far rewinding reaches, in checkpoints
+const long REWIND_MIN_AGE = CHECKPOINT_TICKS / 2;  // Rewinding skips checkpoints younger than this
+
+class StateHistory {
+public:
+    StateHistory();
+
+    // Call after every tick: forgets the checkpoints of a finished round and
+    // takes one every CHECKPOINT_TICKS while the round is being played
+    void afterTick(const World& world);
+
+    // Quick save and load (F5, F6). Loading fails on an empty slot or one
+    // saved under other rules.
+    void save(const World& world);
+    bool load(World& world, std::string& error);
+
+    // Go back to the newest checkpoint at least REWIND_MIN_AGE ticks old and
+    // drop the ones after it (F7); the start of the round if there is none
+    void rewind(World& world);
+
+    int checkpointCount() const { return count; }
+
+    // Newest checkpoint, for dumping from a crash handler. It is never the
+    // one being written, so it can be read from another thread or a signal
+    // handler while the simulation runs on.
+    const WorldState* newestCheckpoint() const { return newest.load(std::memory_order_acquire); }
+
+private:
+    WorldState checkpoints[REWIND_CHECKPOINTS];  // Ring, oldest at `first`
+    int first;
+    int count;
+    WorldState quickSave;
+    uint64_t roundSeed;         // Round the checkpoints belong to
+    long lastTick;
+    std::atomic<const WorldState*> newest;
+
+    void followRound(const World& world);
+    void clear();
+
+    StateHistory(const StateHistory&);
+    StateHistory& operator=(const StateHistory&);
+};
+
+#endif // WORLD_STATE_H